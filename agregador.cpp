@@ -0,0 +1,466 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "armazem.h"
+#include "orcamento.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// --- Agregação dos resultados de uma campanha ---
+//
+// Lê a campanha inteira em paralelo, do armazém (.kpfsr) ou do layout em texto
+// (resultados/ e convergencia/), e grava em <saida>/ três CSVs pequenos para o
+// analise.ipynb:
+//
+//   resumo.csv  por (algoritmo, cenário, tipo, tamanho): execuções, média,
+//               desvio, melhor e pior valor, tempo médio, gap médio até o
+//               melhor valor conhecido da instância e até o limitante, e a
+//               fração de execuções que atingiram o melhor conhecido;
+//   curvas.csv  curva anytime: o melhor valor de cada execução (função degrau
+//               dos pontos de convergência) amostrado numa grade comum de
+//               tempos, com média do valor e do gap entre as execuções que já
+//               têm solução;
+//   ttt.csv     time-to-target: para cada alvo (fração do melhor conhecido),
+//               os tempos das execuções que o atingiram, ordenados, com a
+//               probabilidade empírica (i - 0.5) / n de cada um (gráfico TTT).
+//
+// O melhor conhecido de uma instância é o maior valor da campanha, ou o do
+// arquivo --melhores (linhas "cenario tipo tamanho arquivo valor"), se maior.
+//
+// No layout em texto, a linha k de saida_<tamanho>.txt é a k-ésima instância
+// do grupo na ordem cenário/arquivo; cenário e arquivo vêm dos nomes dos
+// conv_*.txt do mesmo grupo.
+
+// Cenário, tipo, tamanho e arquivo: identificam a instância.
+typedef tuple<int, string, int, int> ChaveInstancia;
+
+inline ChaveInstancia chave_instancia(const ChaveExecucao& c) { return {c.cenario, c.tipo, c.tamanho, c.arquivo}; }
+
+// Algoritmo, cenário, tipo e tamanho: uma linha do resumo.
+inline auto chave_grupo(const ChaveExecucao& c) { return tie(c.algoritmo, c.cenario, c.tipo, c.tamanho); }
+
+struct Opcoes {
+    string entrada = "resultados/campanha.kpfsr";
+    string saida = "analise";
+    string melhores;
+    int threads = (int)max(1u, thread::hardware_concurrency());
+    int pontos = 100;
+    double tempo = 0;  // fim da grade; 0 = maior tempo da campanha
+    vector<double> alvos = {0.95, 0.99, 1.0};
+};
+
+// Executa tarefa(k) para k em [0, n) em 'threads' threads.
+template <class F>
+void paralelo(int n, int threads, F tarefa) {
+    atomic<int> proximo(0);
+    auto worker = [&] {
+        for (int k; (k = proximo.fetch_add(1)) < n;) tarefa(k);
+    };
+    vector<thread> pool;
+    for (int w = 1; w < min(threads, n); ++w) pool.emplace_back(worker);
+    worker();
+    for (thread& t : pool) t.join();
+}
+
+// --- Leitura ---
+
+vector<RegistroExecucao> ler_armazem(const string& caminho, int threads, bool& ok) {
+    LeitorArmazem leitor;
+    ok = leitor.abrir(caminho);
+    if (!ok) return {};
+    vector<vector<RegistroExecucao>> blocos(leitor.blocos());
+    paralelo(leitor.blocos(), threads, [&](int b) { blocos[b] = leitor.ler_bloco(b); });
+    vector<RegistroExecucao> registros;
+    for (auto& bloco : blocos) {
+        registros.insert(registros.end(), make_move_iterator(bloco.begin()), make_move_iterator(bloco.end()));
+    }
+    return registros;
+}
+
+// Números separados por espaço/quebra de linha.
+struct LeitorNumeros {
+    const char* p;
+    const char* fim;
+
+    void pular() {
+        while (p < fim && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    }
+    bool fim_linha() {
+        pular();
+        return p >= fim || *p == '\n';
+    }
+    void proxima_linha() {
+        while (p < fim && *p != '\n') ++p;
+        if (p < fim) ++p;
+    }
+    template <class T>
+    bool ler(T& v) {
+        pular();
+        auto [q, ec] = from_chars(p, fim, v);
+        if (ec != errc()) return false;
+        p = q;
+        return true;
+    }
+};
+
+inline bool ler_convergencia(const string& caminho, vector<pair<double, int>>& pontos) {
+    size_t tamanho = 0;
+    auto mapa = mapear_arquivo(caminho, tamanho);
+    if (!mapa) return tamanho == 0;
+    LeitorNumeros in{mapa.get(), mapa.get() + tamanho};
+    double t;
+    int v;
+    while (in.ler(t) && in.ler(v)) {
+        pontos.push_back({t, v});
+        in.proxima_linha();
+    }
+    return true;
+}
+
+// conv_s<cenario>_t<tipo>_z<tamanho>_f<arquivo>.txt
+inline bool ler_nome_convergencia(const string& nome, int& cenario, int& tamanho, int& arquivo) {
+    if (nome.rfind("conv_s", 0) != 0 || nome.size() < 4 || nome.compare(nome.size() - 4, 4, ".txt") != 0) return false;
+    size_t t = nome.find("_t", 6), z = nome.rfind("_z"), f = nome.rfind("_f");
+    if (t == string::npos || z == string::npos || f == string::npos || !(t < z && z < f)) return false;
+    cenario = atoi(nome.c_str() + 6);
+    tamanho = atoi(nome.c_str() + z + 2);
+    arquivo = atoi(nome.c_str() + f + 2);
+    return true;
+}
+
+// Entradas de 'dir', sem exceções (ler_texto também roda dentro dos workers
+// de paralelo()). Em erro, ec fica preenchido e a lista pode estar parcial.
+vector<fs::directory_entry> listar(const fs::path& dir, error_code& ec) {
+    vector<fs::directory_entry> entradas;
+    for (fs::directory_iterator it(dir, ec), fim; !ec && it != fim; it.increment(ec)) entradas.push_back(*it);
+    return entradas;
+}
+
+inline bool eh_diretorio(const fs::directory_entry& e) {
+    error_code ec;
+    return e.is_directory(ec);
+}
+
+// Layout em texto: uma tarefa por diretório resultados/run_R/<algoritmo>/<tipo>.
+// Um diretório que não pode ser lido é avisado e ignorado.
+vector<RegistroExecucao> ler_texto(const string& base, int threads, bool& ok) {
+    struct Diretorio {
+        int run;
+        string algoritmo, tipo;
+    };
+    mutex trava_avisos;
+    auto ignorar = [&](const fs::path& dir, const error_code& ec) {
+        lock_guard<mutex> lock(trava_avisos);
+        cerr << "Ignorado " << dir.string() << ": " << ec.message() << "\n";
+    };
+    vector<Diretorio> diretorios;
+    error_code ec;
+    for (const auto& run : listar(base + "/resultados", ec)) {
+        string nome_run = run.path().filename().string();
+        if (!eh_diretorio(run) || nome_run.rfind("run_", 0) != 0) continue;
+        error_code ec_run;
+        for (const auto& alg : listar(run.path(), ec_run)) {
+            if (!eh_diretorio(alg)) continue;
+            error_code ec_alg;
+            for (const auto& tipo : listar(alg.path(), ec_alg)) {
+                if (!eh_diretorio(tipo)) continue;
+                diretorios.push_back({atoi(nome_run.c_str() + 4), alg.path().filename().string(), tipo.path().filename().string()});
+            }
+            if (ec_alg) ignorar(alg.path(), ec_alg);
+        }
+        if (ec_run) ignorar(run.path(), ec_run);
+    }
+    ok = !ec;
+
+    vector<vector<RegistroExecucao>> lidos(diretorios.size());
+    paralelo((int)diretorios.size(), threads, [&](int d) {
+        ChaveExecucao grupo;
+        grupo.run = diretorios[d].run;
+        grupo.algoritmo = diretorios[d].algoritmo;
+        grupo.tipo = diretorios[d].tipo;
+
+        // conv_*.txt do diretório, por tamanho, na ordem cenário/arquivo
+        map<int, vector<ChaveExecucao>> por_tamanho;
+        error_code ec_dir;
+        for (const auto& conv : listar(diretorio_convergencia(base, grupo), ec_dir)) {
+            ChaveExecucao c = grupo;
+            if (ler_nome_convergencia(conv.path().filename().string(), c.cenario, c.tamanho, c.arquivo)) {
+                por_tamanho[c.tamanho].push_back(c);
+            }
+        }
+        if (ec_dir) return ignorar(diretorio_convergencia(base, grupo), ec_dir);
+        vector<fs::directory_entry> saidas = listar(diretorio_saida(base, grupo), ec_dir);
+        if (ec_dir) return ignorar(diretorio_saida(base, grupo), ec_dir);
+        for (const auto& saida : saidas) {
+            string nome = saida.path().filename().string();
+            if (nome.rfind("saida_", 0) != 0 || nome.size() < 4 || nome.compare(nome.size() - 4, 4, ".txt") != 0) continue;
+            vector<ChaveExecucao>& chaves = por_tamanho[atoi(nome.c_str() + 6)];
+            sort(chaves.begin(), chaves.end());
+
+            size_t tamanho = 0;
+            auto mapa = mapear_arquivo(saida.path().string(), tamanho);
+            LeitorNumeros in{mapa ? mapa.get() : nullptr, mapa ? mapa.get() + tamanho : nullptr};
+            vector<RegistroExecucao> linhas;
+            RegistroExecucao r;
+            while (mapa && in.ler(r.resultado.valor) && in.ler(r.resultado.tempo)) {
+                r.resultado.limitante = INT_MAX;
+                if (!in.fim_linha()) in.ler(r.resultado.limitante);  // ausente em saídas antigas
+                linhas.push_back(r);
+                in.proxima_linha();
+            }
+            if (linhas.size() != chaves.size()) {
+                lock_guard<mutex> lock(trava_avisos);
+                cerr << "Ignorado " << saida.path().string() << ": " << linhas.size() << " linhas e " << chaves.size()
+                     << " arquivos de convergência.\n";
+                continue;
+            }
+            for (size_t k = 0; k < linhas.size(); ++k) {
+                linhas[k].chave = chaves[k];
+                ler_convergencia(caminho_convergencia(base, chaves[k]), linhas[k].resultado.convergencia);
+                lidos[d].push_back(move(linhas[k]));
+            }
+        }
+    });
+
+    vector<RegistroExecucao> registros;
+    for (auto& v : lidos) registros.insert(registros.end(), make_move_iterator(v.begin()), make_move_iterator(v.end()));
+    return registros;
+}
+
+// --- Estatísticas ---
+
+inline double gap_relativo(double valor, int referencia) { return (referencia - valor) / max(1, abs(referencia)); }
+
+// Valor que atinge a fração 'alvo' do melhor conhecido (também com valores negativos).
+inline double valor_alvo(int melhor_conhecido, double alvo) { return melhor_conhecido - (1 - alvo) * abs(melhor_conhecido); }
+
+struct Saidas {
+    string resumo, curvas, ttt;
+};
+
+Saidas agregar_grupo(const vector<const RegistroExecucao*>& grupo, const map<ChaveInstancia, int>& melhores,
+                     const vector<double>& grade, const vector<double>& alvos) {
+    const ChaveExecucao& c = grupo[0]->chave;
+    ostringstream prefixo;
+    prefixo << c.algoritmo << "," << c.cenario << "," << c.tipo << "," << c.tamanho << ",";
+    const int n = (int)grupo.size();
+    vector<int> melhor_conhecido(n);
+    for (int k = 0; k < n; ++k) melhor_conhecido[k] = melhores.at(chave_instancia(grupo[k]->chave));
+
+    // resumo
+    double soma = 0, soma_tempo = 0, soma_gap = 0, soma_gap_limitante = 0;
+    int melhor = INT_MIN, pior = INT_MAX, com_limitante = 0, atingiram = 0;
+    for (int k = 0; k < n; ++k) {
+        const Resultado& r = grupo[k]->resultado;
+        soma += r.valor;
+        soma_tempo += r.tempo;
+        soma_gap += gap_relativo(r.valor, melhor_conhecido[k]);
+        melhor = max(melhor, r.valor);
+        pior = min(pior, r.valor);
+        atingiram += r.valor >= melhor_conhecido[k];
+        if (r.limitante != INT_MAX) {
+            soma_gap_limitante += gap_otimalidade(r.valor, r.limitante);
+            com_limitante++;
+        }
+    }
+    double media = soma / n, media_tempo = soma_tempo / n, var = 0, var_tempo = 0;
+    for (const RegistroExecucao* r : grupo) {
+        var += (r->resultado.valor - media) * (r->resultado.valor - media);
+        var_tempo += (r->resultado.tempo - media_tempo) * (r->resultado.tempo - media_tempo);
+    }
+    double desvio = n > 1 ? sqrt(var / (n - 1)) : 0, desvio_tempo = n > 1 ? sqrt(var_tempo / (n - 1)) : 0;
+
+    Saidas s;
+    ostringstream resumo;
+    resumo << prefixo.str() << n << "," << media << "," << desvio << "," << melhor << "," << pior << "," << media_tempo << ","
+           << desvio_tempo << "," << soma_gap / n << ",";
+    if (com_limitante > 0) resumo << soma_gap_limitante / com_limitante;
+    resumo << "," << (double)atingiram / n << "\n";
+    s.resumo = resumo.str();
+
+    // curvas: um ponteiro por execução avançando junto com a grade
+    vector<size_t> pos(n, 0);
+    ostringstream curvas;
+    for (double t : grade) {
+        int com_solucao = 0;
+        double soma_valor = 0, soma_gap_t = 0;
+        for (int k = 0; k < n; ++k) {
+            const auto& pontos = grupo[k]->resultado.convergencia;
+            while (pos[k] < pontos.size() && pontos[pos[k]].first <= t) pos[k]++;
+            if (pos[k] == 0) continue;
+            int v = pontos[pos[k] - 1].second;
+            com_solucao++;
+            soma_valor += v;
+            soma_gap_t += gap_relativo(v, melhor_conhecido[k]);
+        }
+        curvas << prefixo.str() << t << "," << com_solucao << ",";
+        if (com_solucao > 0) curvas << soma_valor / com_solucao << "," << soma_gap_t / com_solucao;
+        else curvas << ",";
+        curvas << "\n";
+    }
+    s.curvas = curvas.str();
+
+    // time-to-target
+    ostringstream ttt;
+    for (double alvo : alvos) {
+        vector<double> tempos;
+        for (int k = 0; k < n; ++k) {
+            double objetivo = valor_alvo(melhor_conhecido[k], alvo);
+            for (const auto& ponto : grupo[k]->resultado.convergencia) {
+                if (ponto.second >= objetivo - 1e-9) {
+                    tempos.push_back(ponto.first);
+                    break;
+                }
+            }
+        }
+        sort(tempos.begin(), tempos.end());
+        for (size_t i = 0; i < tempos.size(); ++i) {
+            ttt << prefixo.str() << alvo << "," << tempos[i] << "," << (i + 0.5) / n << "\n";
+        }
+    }
+    s.ttt = ttt.str();
+    return s;
+}
+
+// Linhas "cenario tipo tamanho arquivo valor".
+bool ler_melhores(const string& caminho, map<ChaveInstancia, int>& melhores) {
+    ifstream arquivo(caminho);
+    if (!arquivo.is_open()) return false;
+    int cenario, tamanho, num, valor;
+    string tipo;
+    while (arquivo >> cenario >> tipo >> tamanho >> num >> valor) {
+        auto [it, novo] = melhores.insert({{cenario, tipo, tamanho, num}, valor});
+        if (!novo) it->second = max(it->second, valor);
+    }
+    return true;
+}
+
+// Lista "a,b,..." de frações em (0, 1]; cada item inteiro precisa ser o número.
+bool ler_alvos(const string& texto, vector<double>& alvos) {
+    alvos.clear();
+    for (size_t inicio = 0;;) {
+        size_t virgula = texto.find(',', inicio);
+        string item = texto.substr(inicio, virgula == string::npos ? string::npos : virgula - inicio);
+        double alvo;
+        if (!ler_real_positivo(item.c_str(), alvo) || alvo > 1) return false;
+        alvos.push_back(alvo);
+        if (virgula == string::npos) return true;
+        inicio = virgula + 1;
+    }
+}
+
+void uso(const char* programa) {
+    cerr << "Uso: " << programa << " [--entrada armazem.kpfsr|diretorio] [--saida diretorio] [--threads N]"
+         << " [--pontos N] [--tempo segundos] [--alvos a,b,...] [--melhores arquivo]\n";
+}
+
+int main(int argc, char* argv[]) {
+    Opcoes op;
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        bool valido = true;
+        bool tem_valor = a + 1 < argc;
+        if (arg == "--entrada" && tem_valor) op.entrada = argv[++a];
+        else if (arg == "--saida" && tem_valor) op.saida = argv[++a];
+        else if (arg == "--melhores" && tem_valor) op.melhores = argv[++a];
+        else if (arg == "--threads" && tem_valor) valido = ler_inteiro_entre(argv[++a], 1, INT_MAX, op.threads);
+        else if (arg == "--pontos" && tem_valor) valido = ler_inteiro_entre(argv[++a], 2, INT_MAX, op.pontos);
+        else if (arg == "--tempo" && tem_valor) valido = ler_real_positivo(argv[++a], op.tempo);
+        else if (arg == "--alvos" && tem_valor) valido = ler_alvos(argv[++a], op.alvos);
+        else valido = false;
+        if (!valido) {
+            uso(argv[0]);
+            return 1;
+        }
+    }
+
+    // --- Leitura ---
+    bool ok = false;
+    error_code ec;
+    vector<RegistroExecucao> registros = fs::is_directory(op.entrada, ec) ? ler_texto(op.entrada, op.threads, ok)
+                                                                      : ler_armazem(op.entrada, op.threads, ok);
+    if (!ok) {
+        cerr << "Erro ao ler " << op.entrada << "\n";
+        return 1;
+    }
+    // Uma chave repetida (campanha retomada) fica com o último registro.
+    stable_sort(registros.begin(), registros.end(),
+                [](const RegistroExecucao& a, const RegistroExecucao& b) { return a.chave < b.chave; });
+    vector<const RegistroExecucao*> unicos;
+    for (size_t k = 0; k < registros.size(); ++k) {
+        if (k + 1 < registros.size() && registros[k + 1].chave == registros[k].chave) continue;
+        unicos.push_back(&registros[k]);
+    }
+    if (unicos.empty()) {
+        cerr << "Nenhuma execução em " << op.entrada << "\n";
+        return 1;
+    }
+
+    // --- Melhor conhecido e grade de tempo ---
+    map<ChaveInstancia, int> melhores;
+    if (!op.melhores.empty() && !ler_melhores(op.melhores, melhores)) {
+        cerr << "Erro ao abrir " << op.melhores << "\n";
+        return 1;
+    }
+    double tempo_max = op.tempo;
+    for (const RegistroExecucao* r : unicos) {
+        auto [it, novo] = melhores.insert({chave_instancia(r->chave), r->resultado.valor});
+        if (!novo) it->second = max(it->second, r->resultado.valor);
+        if (op.tempo == 0) {
+            tempo_max = max(tempo_max, r->resultado.tempo);
+            if (!r->resultado.convergencia.empty()) tempo_max = max(tempo_max, r->resultado.convergencia.back().first);
+        }
+    }
+    vector<double> grade(op.pontos);
+    for (int k = 0; k < op.pontos; ++k) grade[k] = tempo_max * k / (op.pontos - 1);
+
+    // --- Grupos (algoritmo, cenário, tipo, tamanho), em paralelo ---
+    stable_sort(unicos.begin(), unicos.end(), [](const RegistroExecucao* a, const RegistroExecucao* b) {
+        return chave_grupo(a->chave) < chave_grupo(b->chave);
+    });
+    vector<vector<const RegistroExecucao*>> grupos;
+    for (size_t k = 0; k < unicos.size(); ++k) {
+        if (k == 0 || chave_grupo(unicos[k]->chave) != chave_grupo(unicos[k - 1]->chave)) grupos.emplace_back();
+        grupos.back().push_back(unicos[k]);
+    }
+    vector<Saidas> saidas(grupos.size());
+    paralelo((int)grupos.size(), op.threads,
+             [&](int g) { saidas[g] = agregar_grupo(grupos[g], melhores, grade, op.alvos); });
+
+    // --- Escrita ---
+    fs::create_directories(op.saida);
+    const string cabecalho = "algoritmo,cenario,tipo,tamanho,";
+    ofstream resumo(op.saida + "/resumo.csv"), curvas(op.saida + "/curvas.csv"), ttt(op.saida + "/ttt.csv");
+    resumo << cabecalho
+           << "execucoes,valor_medio,valor_std,melhor,pior,tempo_medio,tempo_std,gap_melhor_conhecido,gap_limitante,"
+              "atingiu_melhor_conhecido\n";
+    curvas << cabecalho << "tempo,com_solucao,valor_medio,gap_medio\n";
+    ttt << cabecalho << "alvo,tempo,probabilidade\n";
+    for (const Saidas& s : saidas) {
+        resumo << s.resumo;
+        curvas << s.curvas;
+        ttt << s.ttt;
+    }
+    if (!resumo || !curvas || !ttt) {
+        cerr << "Erro ao escrever em " << op.saida << "\n";
+        return 1;
+    }
+    cout << unicos.size() << " execuções, " << melhores.size() << " instâncias, " << grupos.size() << " grupos -> "
+         << op.saida << "/{resumo,curvas,ttt}.csv\n";
+    return 0;
+}
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "kpfs.h"
+#include "resultado.h"
+
+// --- Armazém de resultados de uma campanha (.kpfsr) ---
+//
+// Um arquivo por campanha, só de acréscimo, no lugar dos milhares de
+// saida_*.txt e conv_*.txt. Cada registro é uma execução, identificada por
+// (run, algoritmo, cenário, tipo, tamanho, arquivo). Os registros ficam num
+// buffer e são gravados em blocos colunares:
+//
+//   CabecalhoBloco
+//   nomes      uint16 quantidade; por nome, uint16 tamanho + bytes
+//              (algoritmos e tipos que aparecem no bloco)
+//   chave      run u16[n] algoritmo u16[n] cenario u16[n] tipo u16[n]
+//              tamanho u32[n] arquivo u16[n]   (algoritmo e tipo indexam 'nomes')
+//   valores    semente u64[n] valor i32[n] limitante i32[n] tempo f64[n]
+//              fim_pontos u32[n] fim_contadores u32[n]   (fins acumulados)
+//   pontos     tempo f64[p] valor i32[p]   (convergência, registro após registro)
+//   contadores texto JSON de cada registro (vazio sem KPFS_INSTRUMENTACAO)
+//
+// O cabeçalho guarda o tamanho do corpo e uma soma FNV-1a dele: um bloco
+// incompleto no fim (processo interrompido no meio da escrita) é descartado
+// na leitura e sobrescrito no próximo acréscimo.
+//
+// Índice: <armazém>.idx, uma EntradaIndice por bloco. O leitor vai direto aos
+// blocos e, para procurar uma chave, decodifica só as colunas de chave. Cada
+// bloco do índice é conferido (limites, cabeçalho e soma) ao abrir; um índice
+// ausente, atrasado ou que não bate com os dados é refeito percorrendo os
+// blocos.
+
+const char MAGICA_ARMAZEM[4] = {'K', 'P', 'F', 'R'};
+const uint32_t VERSAO_ARMAZEM = 1;
+const char MAGICA_BLOCO[4] = {'B', 'L', 'O', 'C'};
+
+const int REGISTROS_POR_BLOCO = 4096;
+const size_t BYTES_POR_BLOCO = 1 << 20;  // grava antes, se o buffer passar disso
+
+struct CabecalhoArmazem {
+    char magica[4];
+    uint32_t versao;
+};
+static_assert(sizeof(CabecalhoArmazem) == 8, "cabecalho .kpfsr deve ter 8 bytes");
+
+struct CabecalhoBloco {
+    char magica[4];
+    uint32_t registros;
+    uint32_t pontos;
+    uint32_t bytes;  // tamanho do corpo, sem o cabeçalho
+    uint64_t soma;   // FNV-1a do corpo
+};
+static_assert(sizeof(CabecalhoBloco) == 24, "cabecalho de bloco deve ter 24 bytes");
+
+struct EntradaIndice {
+    uint64_t posicao;  // do cabeçalho do bloco no arquivo de dados
+    uint32_t registros;
+    uint32_t bytes;
+};
+static_assert(sizeof(EntradaIndice) == 16, "entrada do indice deve ter 16 bytes");
+
+struct ChaveExecucao {
+    int run = 0;
+    std::string algoritmo;
+    int cenario = 0;
+    std::string tipo;
+    int tamanho = 0;
+    int arquivo = 0;
+
+    // Ordem dos arquivos de texto: grupo (run, algoritmo, tipo, tamanho) e,
+    // dentro dele, cenário/arquivo.
+    auto campos() const { return std::tie(run, algoritmo, tipo, tamanho, cenario, arquivo); }
+    bool operator<(const ChaveExecucao& o) const { return campos() < o.campos(); }
+    bool operator==(const ChaveExecucao& o) const { return campos() == o.campos(); }
+};
+
+struct RegistroExecucao {
+    ChaveExecucao chave;
+    uint64_t semente = 0;
+    Resultado resultado;     // contadores não são guardados como struct...
+    std::string contadores;  // ...e sim como a linha JSON (formatar_contadores)
+};
+
+// Caminhos do layout em texto, relativos a 'base' (os mesmos do leitura_exec).
+inline std::string diretorio_saida(const std::string& base, const ChaveExecucao& c) {
+    return base + "/resultados/run_" + std::to_string(c.run) + "/" + c.algoritmo + "/" + c.tipo;
+}
+
+inline std::string caminho_saida(const std::string& base, const ChaveExecucao& c) {
+    return diretorio_saida(base, c) + "/saida_" + std::to_string(c.tamanho) + ".txt";
+}
+
+inline std::string diretorio_convergencia(const std::string& base, const ChaveExecucao& c) {
+    return base + "/convergencia/run_" + std::to_string(c.run) + "/" + c.algoritmo + "/" + c.tipo;
+}
+
+inline std::string caminho_convergencia(const std::string& base, const ChaveExecucao& c) {
+    return diretorio_convergencia(base, c) + "/conv_s" + std::to_string(c.cenario) + "_t" + c.tipo + "_z" +
+           std::to_string(c.tamanho) + "_f" + std::to_string(c.arquivo) + ".txt";
+}
+
+namespace detalhe_armazem {
+
+inline uint64_t fnv1a(const char* p, size_t n) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t k = 0; k < n; ++k) h = (h ^ (unsigned char)p[k]) * 0x100000001b3ULL;
+    return h;
+}
+
+inline bool escrever_tudo(int fd, const std::string& s) {
+    size_t feito = 0;
+    while (feito < s.size()) {
+        ssize_t n = ::write(fd, s.data() + feito, s.size() - feito);
+        if (n <= 0) return false;
+        feito += (size_t)n;
+    }
+    return true;
+}
+
+template <class T>
+void anexar(std::string& s, T v) {
+    s.append((const char*)&v, sizeof(T));
+}
+
+// Lê valores de um corpo de bloco; 'ok' cai para false ao passar do fim.
+struct Cursor {
+    const char* p;
+    const char* fim;
+    bool ok = true;
+
+    template <class T>
+    T ler() {
+        T v{};
+        if (fim - p < (std::ptrdiff_t)sizeof(T)) {
+            ok = false;
+            return v;
+        }
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+
+    // Início de uma coluna de n valores T; o cursor pula a coluna.
+    template <class T>
+    const char* coluna(size_t n) {
+        const char* inicio = p;
+        if ((size_t)(fim - p) < n * sizeof(T)) {
+            ok = false;
+            return p;
+        }
+        p += n * sizeof(T);
+        return inicio;
+    }
+};
+
+template <class T>
+T elemento(const char* coluna, size_t k) {
+    T v;
+    std::memcpy(&v, coluna + k * sizeof(T), sizeof(T));
+    return v;
+}
+
+inline std::string codificar_bloco(const std::vector<RegistroExecucao>& regs) {
+    std::vector<std::string> nomes;
+    auto indice_nome = [&](const std::string& nome) {
+        auto it = std::find(nomes.begin(), nomes.end(), nome);
+        if (it != nomes.end()) return (uint16_t)(it - nomes.begin());
+        nomes.push_back(nome);
+        return (uint16_t)(nomes.size() - 1);
+    };
+    std::vector<uint16_t> algoritmo, tipo;
+    for (const RegistroExecucao& r : regs) {
+        algoritmo.push_back(indice_nome(r.chave.algoritmo));
+        tipo.push_back(indice_nome(r.chave.tipo));
+    }
+
+    std::string corpo;
+    anexar<uint16_t>(corpo, (uint16_t)nomes.size());
+    for (const std::string& nome : nomes) {
+        anexar<uint16_t>(corpo, (uint16_t)nome.size());
+        corpo += nome;
+    }
+    for (const RegistroExecucao& r : regs) anexar<uint16_t>(corpo, (uint16_t)r.chave.run);
+    for (uint16_t a : algoritmo) anexar<uint16_t>(corpo, a);
+    for (const RegistroExecucao& r : regs) anexar<uint16_t>(corpo, (uint16_t)r.chave.cenario);
+    for (uint16_t t : tipo) anexar<uint16_t>(corpo, t);
+    for (const RegistroExecucao& r : regs) anexar<uint32_t>(corpo, (uint32_t)r.chave.tamanho);
+    for (const RegistroExecucao& r : regs) anexar<uint16_t>(corpo, (uint16_t)r.chave.arquivo);
+
+    uint32_t pontos = 0, texto = 0;
+    for (const RegistroExecucao& r : regs) anexar<uint64_t>(corpo, r.semente);
+    for (const RegistroExecucao& r : regs) anexar<int32_t>(corpo, r.resultado.valor);
+    for (const RegistroExecucao& r : regs) anexar<int32_t>(corpo, r.resultado.limitante);
+    for (const RegistroExecucao& r : regs) anexar<double>(corpo, r.resultado.tempo);
+    for (const RegistroExecucao& r : regs) anexar<uint32_t>(corpo, pontos += (uint32_t)r.resultado.convergencia.size());
+    for (const RegistroExecucao& r : regs) anexar<uint32_t>(corpo, texto += (uint32_t)r.contadores.size());
+
+    for (const RegistroExecucao& r : regs) {
+        for (const auto& ponto : r.resultado.convergencia) anexar<double>(corpo, ponto.first);
+    }
+    for (const RegistroExecucao& r : regs) {
+        for (const auto& ponto : r.resultado.convergencia) anexar<int32_t>(corpo, ponto.second);
+    }
+    for (const RegistroExecucao& r : regs) corpo += r.contadores;
+
+    CabecalhoBloco cab{};
+    std::memcpy(cab.magica, MAGICA_BLOCO, 4);
+    cab.registros = (uint32_t)regs.size();
+    cab.pontos = pontos;
+    cab.bytes = (uint32_t)corpo.size();
+    cab.soma = fnv1a(corpo.data(), corpo.size());
+    std::string bloco((const char*)&cab, sizeof(cab));
+    return bloco + corpo;
+}
+
+// Colunas de um bloco, apontando para o arquivo mapeado.
+struct ColunasBloco {
+    uint32_t registros = 0, pontos = 0;
+    std::vector<std::string> nomes;
+    const char *run, *algoritmo, *cenario, *tipo, *tamanho, *arquivo;
+    const char *semente, *valor, *limitante, *tempo, *fim_pontos, *fim_contadores;
+    const char *ponto_tempo, *ponto_valor, *texto;
+
+    bool decodificar(const char* bloco) {
+        CabecalhoBloco cab;
+        std::memcpy(&cab, bloco, sizeof(cab));
+        registros = cab.registros;
+        pontos = cab.pontos;
+        Cursor c{bloco + sizeof(cab), bloco + sizeof(cab) + cab.bytes};
+        int n_nomes = c.ler<uint16_t>();
+        for (int k = 0; k < n_nomes && c.ok; ++k) {
+            uint16_t tam = c.ler<uint16_t>();
+            const char* s = c.coluna<char>(tam);
+            nomes.emplace_back(s, c.ok ? tam : 0);
+        }
+        size_t n = registros;
+        run = c.coluna<uint16_t>(n);
+        algoritmo = c.coluna<uint16_t>(n);
+        cenario = c.coluna<uint16_t>(n);
+        tipo = c.coluna<uint16_t>(n);
+        tamanho = c.coluna<uint32_t>(n);
+        arquivo = c.coluna<uint16_t>(n);
+        semente = c.coluna<uint64_t>(n);
+        valor = c.coluna<int32_t>(n);
+        limitante = c.coluna<int32_t>(n);
+        tempo = c.coluna<double>(n);
+        fim_pontos = c.coluna<uint32_t>(n);
+        fim_contadores = c.coluna<uint32_t>(n);
+        ponto_tempo = c.coluna<double>(pontos);
+        ponto_valor = c.coluna<int32_t>(pontos);
+        texto = c.p;
+        return c.ok;
+    }
+
+    std::string nome(const char* coluna, size_t k) const {
+        uint16_t i = elemento<uint16_t>(coluna, k);
+        return i < nomes.size() ? nomes[i] : std::string();
+    }
+
+    ChaveExecucao chave(size_t k) const {
+        ChaveExecucao c;
+        c.run = elemento<uint16_t>(run, k);
+        c.algoritmo = nome(algoritmo, k);
+        c.cenario = elemento<uint16_t>(cenario, k);
+        c.tipo = nome(tipo, k);
+        c.tamanho = (int)elemento<uint32_t>(tamanho, k);
+        c.arquivo = elemento<uint16_t>(arquivo, k);
+        return c;
+    }
+
+    RegistroExecucao registro(size_t k) const {
+        RegistroExecucao r;
+        r.chave = chave(k);
+        r.semente = elemento<uint64_t>(semente, k);
+        r.resultado.valor = elemento<int32_t>(valor, k);
+        r.resultado.limitante = elemento<int32_t>(limitante, k);
+        r.resultado.tempo = elemento<double>(tempo, k);
+        uint32_t p0 = k == 0 ? 0 : elemento<uint32_t>(fim_pontos, k - 1), p1 = elemento<uint32_t>(fim_pontos, k);
+        for (uint32_t p = p0; p < p1 && p < pontos; ++p) {
+            r.resultado.convergencia.push_back({elemento<double>(ponto_tempo, p), elemento<int32_t>(ponto_valor, p)});
+        }
+        uint32_t t0 = k == 0 ? 0 : elemento<uint32_t>(fim_contadores, k - 1), t1 = elemento<uint32_t>(fim_contadores, k);
+        r.contadores.assign(texto + t0, t1 - t0);
+        return r;
+    }
+};
+
+}  // namespace detalhe_armazem
+
+inline std::string caminho_indice(const std::string& caminho_armazem) { return caminho_armazem + ".idx"; }
+
+// Leitura de um armazém (mapeado em memória). Só lê: pode ser usado enquanto
+// outro processo acrescenta, vendo os blocos completos até a abertura.
+class LeitorArmazem {
+public:
+    bool abrir(const std::string& caminho) {
+        blocos_.clear();
+        fim_valido_ = 0;
+        mapa_ = mapear_arquivo(caminho, tamanho_);
+        if (!mapa_ || tamanho_ < sizeof(CabecalhoArmazem)) return false;
+        CabecalhoArmazem cab;
+        std::memcpy(&cab, mapa_.get(), sizeof(cab));
+        if (std::memcmp(cab.magica, MAGICA_ARMAZEM, 4) != 0 || cab.versao != VERSAO_ARMAZEM) return false;
+        fim_valido_ = sizeof(cab);
+
+        // Blocos do índice enquanto ele bate com os dados; do primeiro que não
+        // bate (índice velho ou corrompido) em diante, percorrendo o arquivo.
+        std::ifstream idx(caminho_indice(caminho), std::ios::binary);
+        EntradaIndice e, lido;
+        while (idx.read((char*)&e, sizeof(e)) && e.posicao == fim_valido_ && bloco_integro(e.posicao, lido) &&
+               lido.registros == e.registros && lido.bytes == e.bytes) {
+            blocos_.push_back(lido);
+            fim_valido_ += sizeof(CabecalhoBloco) + lido.bytes;
+        }
+        while (bloco_integro(fim_valido_, lido)) {
+            blocos_.push_back(lido);
+            fim_valido_ += sizeof(CabecalhoBloco) + lido.bytes;
+        }
+        std::error_code ec;
+        uint64_t bytes_indice = std::filesystem::file_size(caminho_indice(caminho), ec);
+        indice_completo_ = !ec && bytes_indice == blocos_.size() * sizeof(EntradaIndice);
+        return true;
+    }
+
+    int blocos() const { return (int)blocos_.size(); }
+    const std::vector<EntradaIndice>& indice() const { return blocos_; }
+    // Bytes até o fim do último bloco íntegro (o resto é lixo de uma escrita interrompida).
+    uint64_t fim_valido() const { return fim_valido_; }
+    // O .idx existe e descreve exatamente os blocos válidos.
+    bool indice_completo() const { return indice_completo_; }
+
+    size_t registros() const {
+        size_t n = 0;
+        for (const EntradaIndice& e : blocos_) n += e.registros;
+        return n;
+    }
+
+    std::vector<ChaveExecucao> chaves_bloco(int b) const {
+        detalhe_armazem::ColunasBloco col;
+        std::vector<ChaveExecucao> chaves;
+        if (!col.decodificar(mapa_.get() + blocos_[b].posicao)) return chaves;
+        for (size_t k = 0; k < col.registros; ++k) chaves.push_back(col.chave(k));
+        return chaves;
+    }
+
+    std::vector<RegistroExecucao> ler_bloco(int b) const {
+        detalhe_armazem::ColunasBloco col;
+        std::vector<RegistroExecucao> regs;
+        if (!col.decodificar(mapa_.get() + blocos_[b].posicao)) return regs;
+        for (size_t k = 0; k < col.registros; ++k) regs.push_back(col.registro(k));
+        return regs;
+    }
+
+    std::vector<RegistroExecucao> ler_todos() const {
+        std::vector<RegistroExecucao> regs;
+        for (int b = 0; b < blocos(); ++b) {
+            std::vector<RegistroExecucao> bloco = ler_bloco(b);
+            regs.insert(regs.end(), std::make_move_iterator(bloco.begin()), std::make_move_iterator(bloco.end()));
+        }
+        return regs;
+    }
+
+    // Última ocorrência da chave (um registro repetido substitui o anterior).
+    bool buscar(const ChaveExecucao& chave, RegistroExecucao& r) const {
+        for (int b = blocos() - 1; b >= 0; --b) {
+            detalhe_armazem::ColunasBloco col;
+            if (!col.decodificar(mapa_.get() + blocos_[b].posicao)) continue;
+            for (size_t k = col.registros; k-- > 0;) {
+                if (col.chave(k) == chave) {
+                    r = col.registro(k);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    std::shared_ptr<const char> mapa_;
+    size_t tamanho_ = 0;
+    std::vector<EntradaIndice> blocos_;
+    uint64_t fim_valido_ = 0;
+    bool indice_completo_ = false;
+
+    // Bloco inteiro dentro do arquivo, com a mágica e a soma do corpo certas.
+    bool bloco_integro(uint64_t posicao, EntradaIndice& e) const {
+        if (posicao + sizeof(CabecalhoBloco) > tamanho_) return false;
+        CabecalhoBloco cb;
+        std::memcpy(&cb, mapa_.get() + posicao, sizeof(cb));
+        if (std::memcmp(cb.magica, MAGICA_BLOCO, 4) != 0 || posicao + sizeof(cb) + cb.bytes > tamanho_) return false;
+        if (detalhe_armazem::fnv1a(mapa_.get() + posicao + sizeof(cb), cb.bytes) != cb.soma) return false;
+        e = {posicao, cb.registros, cb.bytes};
+        return true;
+    }
+};
+
+// Escrita com buffer; adicionar() pode ser chamado de várias threads. Um bloco
+// é gravado (dados e depois índice) quando o buffer enche, quando o registro
+// pendente mais antigo passa de 'intervalo' segundos (visto em adicionar() e em
+// descarregar_vencido()), em descarregar() e em fechar(). Com 'ao_gravar' definido, dados e índice vão para o disco (fsync)
+// antes de ele ser chamado com os registros do bloco e o novo tamanho do
+// arquivo: é o ponto em que o bloco pode ser dado como durável.
+class EscritorArmazem {
+public:
+    typedef std::function<bool(const std::vector<RegistroExecucao>&, uint64_t)> Confirmacao;
+
+    double intervalo = 60.0;
+    Confirmacao ao_gravar;
+
+    ~EscritorArmazem() { fechar(); }
+
+    // acrescentar = false começa um armazém vazio; true continua um existente,
+    // descartando os bytes depois do último bloco íntegro que termina até
+    // 'limite' e refazendo o índice se preciso. Com 'limite' finito, os blocos
+    // até ele têm de estar todos lá (foram confirmados a alguém): falta de
+    // bloco, ou armazém ausente ou ilegível com limite > 0, é erro, e nada é
+    // apagado.
+    bool abrir(const std::string& caminho, bool acrescentar, uint64_t limite = UINT64_MAX) {
+        std::lock_guard<std::mutex> lock(trava_), lock_escrita(trava_escrita_);
+        caminho_ = caminho;
+        erro_ = false;
+        LeitorArmazem existente;
+        bool aberto = acrescentar && existente.abrir(caminho);
+        if (acrescentar && !aberto && limite > 0) return false;
+        if (aberto) {
+            std::vector<EntradaIndice> indice = existente.indice();
+            bool completo = existente.indice_completo();
+            uint64_t fim = sizeof(CabecalhoArmazem);
+            size_t mantidos = 0;
+            for (; mantidos < indice.size(); ++mantidos) {
+                uint64_t fim_bloco = indice[mantidos].posicao + sizeof(CabecalhoBloco) + indice[mantidos].bytes;
+                if (fim_bloco > limite) break;
+                fim = fim_bloco;
+            }
+            if (limite != UINT64_MAX && limite > sizeof(CabecalhoArmazem) && fim != limite) return false;
+            completo &= mantidos == indice.size();
+            indice.resize(mantidos);
+            existente = LeitorArmazem();  // solta o mapeamento antes de truncar
+            std::error_code ec;
+            if (std::filesystem::file_size(caminho, ec) != fim) std::filesystem::resize_file(caminho, fim, ec);
+            if (ec) return false;
+            if (!completo) {
+                std::string bytes((const char*)indice.data(), indice.size() * sizeof(EntradaIndice));
+                std::ofstream idx(caminho_indice(caminho), std::ios::binary | std::ios::trunc);
+                idx << bytes;
+                if (!idx) return false;
+            }
+            posicao_ = fim;
+        } else {
+            CabecalhoArmazem cab{};
+            std::memcpy(cab.magica, MAGICA_ARMAZEM, 4);
+            cab.versao = VERSAO_ARMAZEM;
+            std::ofstream novo(caminho, std::ios::binary | std::ios::trunc);
+            novo.write((const char*)&cab, sizeof(cab));
+            std::ofstream idx(caminho_indice(caminho), std::ios::binary | std::ios::trunc);
+            if (!novo || !idx) return false;
+            posicao_ = sizeof(cab);
+        }
+        dados_ = ::open(caminho.c_str(), O_WRONLY | O_APPEND);
+        indice_ = ::open(caminho_indice(caminho).c_str(), O_WRONLY | O_APPEND);
+        return dados_ >= 0 && indice_ >= 0;
+    }
+
+    void adicionar(RegistroExecucao r) {
+        std::vector<RegistroExecucao> bloco;
+        {
+            std::lock_guard<std::mutex> lock(trava_);
+            if (erro_) return;  // nada mais é gravado: não acumula
+            if (pendentes_.empty()) primeiro_pendente_ = std::chrono::steady_clock::now();
+            bytes_pendentes_ += 64 + r.resultado.convergencia.size() * 12 + r.contadores.size();
+            pendentes_.push_back(std::move(r));
+            if ((int)pendentes_.size() >= REGISTROS_POR_BLOCO || bytes_pendentes_ >= BYTES_POR_BLOCO || vencido()) {
+                bloco = retirar();
+            }
+        }
+        gravar_bloco(std::move(bloco));
+    }
+
+    // Grava o bloco pendente se o registro mais antigo já espera há
+    // 'intervalo' segundos. Para ser chamado periodicamente por quem adiciona,
+    // para que execuções lentas no fim da campanha não segurem um bloco.
+    void descarregar_vencido() {
+        std::vector<RegistroExecucao> bloco;
+        {
+            std::lock_guard<std::mutex> lock(trava_);
+            if (vencido()) bloco = retirar();
+        }
+        gravar_bloco(std::move(bloco));
+    }
+
+    // Grava o bloco pendente. Devolve false se alguma escrita falhou.
+    bool descarregar() {
+        std::vector<RegistroExecucao> bloco;
+        {
+            std::lock_guard<std::mutex> lock(trava_);
+            bloco = retirar();
+        }
+        gravar_bloco(std::move(bloco));
+        return !erro_;
+    }
+
+    bool fechar() {
+        bool ok = descarregar();
+        std::lock_guard<std::mutex> lock(trava_escrita_);
+        if (dados_ >= 0) {
+            ::close(dados_);
+            ::close(indice_);
+        }
+        dados_ = indice_ = -1;
+        return ok;
+    }
+
+private:
+    // trava_ protege o buffer; trava_escrita_, os arquivos e posicao_. A
+    // codificação, as escritas e os fsync de um bloco acontecem fora de
+    // trava_, e quem adiciona não espera pelo disco.
+    std::mutex trava_, trava_escrita_;
+    std::string caminho_;
+    int dados_ = -1, indice_ = -1;
+    uint64_t posicao_ = 0;
+    std::vector<RegistroExecucao> pendentes_;
+    size_t bytes_pendentes_ = 0;
+    std::chrono::steady_clock::time_point primeiro_pendente_;
+    std::atomic<bool> erro_{false};
+
+    bool vencido() const {
+        return !pendentes_.empty() &&
+               std::chrono::duration<double>(std::chrono::steady_clock::now() - primeiro_pendente_).count() >= intervalo;
+    }
+
+    std::vector<RegistroExecucao> retirar() {
+        std::vector<RegistroExecucao> bloco;
+        bloco.swap(pendentes_);
+        bytes_pendentes_ = 0;
+        return bloco;
+    }
+
+    void gravar_bloco(std::vector<RegistroExecucao> regs) {
+        if (regs.empty() || erro_) return;
+        std::string bloco = detalhe_armazem::codificar_bloco(regs);
+        std::lock_guard<std::mutex> lock(trava_escrita_);
+        if (dados_ < 0 || erro_) return;
+        EntradaIndice e{posicao_, (uint32_t)regs.size(), (uint32_t)(bloco.size() - sizeof(CabecalhoBloco))};
+        bool ok = detalhe_armazem::escrever_tudo(dados_, bloco) &&
+                  detalhe_armazem::escrever_tudo(indice_, std::string((const char*)&e, sizeof(e)));
+        if (ok && ao_gravar) {
+            ok = ::fsync(dados_) == 0 && ::fsync(indice_) == 0 && ao_gravar(regs, posicao_ + bloco.size());
+        }
+        posicao_ += bloco.size();
+        if (!ok) {
+            // O arquivo pode ter um bloco pela metade; nada mais é gravado (a
+            // leitura para no último bloco íntegro) e o buffer é descartado.
+            std::lock_guard<std::mutex> trava(trava_);
+            erro_ = true;
+            pendentes_.clear();
+            bytes_pendentes_ = 0;
+        }
+    }
+};
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "contagem.h"
+#include "instrumentacao.h"
+#include "kpfs.h"
+#include "solucao.h"
+#include "vizinhanca.h"
+
+// --- Motor de avaliação incremental de movimentos (flip de um item) ---
+//
+// Mantém a solução, o valor, o peso, itemsPorConj e, para cada item, o ganho
+// de invertê-lo (ganho[i] = valor após o flip - valor atual, sem considerar a
+// capacidade). Ao aplicar um flip, só mudam os ganhos dos itens que dividem
+// com ele um conjunto cujo contador cruzou o limite:
+//   - itens selecionados pagam custo se itemsPorConj > lim, logo só mudam quando
+//     o contador passa entre lim e lim + 1;
+//   - itens fora pagam custo se itemsPorConj >= lim, logo só mudam quando o
+//     contador passa entre lim - 1 e lim.
+// Os membros de cada conjunto vêm da adjacência conjunto -> itens da instância.
+// carregar() calcula todos os ganhos de uma vez com avaliar_vizinhanca(), que
+// usa SIMD quando a CPU tem (o layout só é montado nesse caso), e conta os
+// itens por conjunto com máscaras de bits (contagem.h) quando compensa.
+//
+// Perturbações e reconstruções também podem ser feitas por flips: aplicar()
+// anota cada item invertido entre iniciar_registro() e confirmar()/desfazer(),
+// e desfazer() inverte de volta, do último ao primeiro, restaurando o estado
+// exato. mover_para() leva o motor a outra solução pelos flips da diferença.
+// Os dois caem para carregar() quando os flips custariam mais (custo_flip() x
+// custo_carga()).
+//
+// Os ganhos ficam em duas árvores de torneio (itens dentro e fora da solução),
+// com as folhas ordenadas por peso. Assim, os itens fora que ainda cabem formam
+// um prefixo das folhas, e melhor_movimento() percorre em ordem decrescente de
+// ganho (empate: menor índice) só os movimentos que respeitam a capacidade, até
+// achar um admissível.
+
+// Por posição visitada, carregar() (sequencial e vetorizado) sai ~5x mais
+// barato que os flips (acessos espalhados); medido nas instâncias de 300 a 3000 itens.
+const double CUSTO_RELATIVO_CARGA = 0.2;
+
+template <class Solucao>
+struct MotorGanho {
+    const Instancia& inst;
+    Solucao sol;
+    int valor = 0;
+    int somaPeso = 0;
+    std::vector<contador_t> itemsPorConj;
+    std::vector<int> ganho;
+
+    explicit MotorGanho(const Instancia& inst)
+        : inst(inst), sol(inst.itens), itemsPorConj(inst.quant_conj, 0), ganho(inst.itens, 0) {
+        if (cpu_tem_avx2()) layout = LayoutVizinhanca(inst);
+        contagem = ContagemConjuntos(inst);
+        folhas = 1;
+        while (folhas < std::max(inst.itens, 1)) {
+            folhas <<= 1;
+            niveis++;
+        }
+        arv[DENTRO].assign(2 * folhas, -1);
+        arv[FORA].assign(2 * folhas, -1);
+        sujo.assign(inst.itens, 0);
+
+        std::vector<int> ordem(inst.itens);
+        for (int i = 0; i < inst.itens; ++i) ordem[i] = i;
+        std::stable_sort(ordem.begin(), ordem.end(), [&](int a, int b) { return inst.peso[a] < inst.peso[b]; });
+        pos.assign(inst.itens, 0);
+        peso_ordenado.assign(inst.itens, 0);
+        for (int p = 0; p < inst.itens; ++p) {
+            pos[ordem[p]] = p;
+            peso_ordenado[p] = inst.peso[ordem[p]];
+        }
+    }
+
+    bool viavel() const { return somaPeso <= inst.capacidade; }
+
+    // O flip de 'item' respeita a capacidade?
+    bool cabe(int item) const { return sol[item] || somaPeso + inst.peso[item] <= inst.capacidade; }
+
+    // Recalcula todo o estado a partir de uma solução. O(nnz). Durante um
+    // registro, desfazer() passa a recarregar em vez de inverter.
+    void carregar(const Solucao& s) {
+        CONTAR(reavaliacoes);
+        if (registrando) {
+            registro.clear();
+            recarregado = true;
+        }
+        carregado = true;
+        sol = s;
+        somaPeso = 0;
+        int soma_valor = 0;
+        std::fill(itemsPorConj.begin(), itemsPorConj.end(), 0);
+        bool mascaras = contagem.compensa(sol.count());
+        for (int i = 0; i < inst.itens; ++i) {
+            if (sol[i]) {
+                somaPeso += inst.peso[i];
+                soma_valor += inst.lucro[i];
+                if (!mascaras) {
+                    for (int cj : inst.conjuntos(i)) itemsPorConj[cj]++;
+                }
+            }
+        }
+        if (mascaras) contagem.contar(inst, sol, itemsPorConj);
+        int penalidade = 0;
+        for (int j = 0; j < inst.quant_conj; ++j) {
+            if (itemsPorConj[j] > inst.lim_conj[j]) penalidade += (itemsPorConj[j] - inst.lim_conj[j]) * inst.custo_conj[j];
+        }
+        valor = soma_valor - penalidade;
+
+        avaliar_vizinhanca(inst, layout, sol, itemsPorConj, somaPeso, ganho.data(), nullptr, selecao);
+        for (int i = 0; i < inst.itens; ++i) {
+            arv[DENTRO][folhas + pos[i]] = sol[i] ? i : -1;
+            arv[FORA][folhas + pos[i]] = sol[i] ? -1 : i;
+        }
+        for (int t : {DENTRO, FORA}) {
+            for (int k = folhas - 1; k >= 1; --k) arv[t][k] = melhor(arv[t][2 * k], arv[t][2 * k + 1]);
+        }
+    }
+
+    // Ganho do flip de 'item' calculado do zero, percorrendo seus conjuntos.
+    int calcular_ganho(int item) const { return ganho_flip(inst, sol, itemsPorConj, item); }
+
+    // Inverte 'item' e atualiza apenas os ganhos afetados.
+    void aplicar(int item) {
+        CONTAR(movimentos_aceitos);
+        if (registrando) registro.push_back(item);
+        inverter(item);
+    }
+
+    // Passa a anotar os flips de aplicar() para um possível desfazer().
+    void iniciar_registro() {
+        registro.clear();
+        registrando = true;
+        recarregado = false;
+        sol_registro = sol;
+    }
+
+    // Mantém os flips anotados e para de anotar.
+    void confirmar() {
+        registro.clear();
+        registrando = false;
+        recarregado = false;
+    }
+
+    size_t registro_tamanho() const { return registro.size(); }
+
+    // Custos estimados, em "posições visitadas": um flip percorre os conjuntos
+    // do item, os membros dos conjuntos que cruzam o limite e sobe cada ganho
+    // alterado nas árvores (média observada até aqui); carregar() percorre a
+    // adjacência toda e monta as árvores.
+    double custo_flip() const {
+        return flips_medidos ? (double)trabalho_flips / flips_medidos : (double)inst.nnz / std::max(inst.itens, 1);
+    }
+    double custo_carga() const { return CUSTO_RELATIVO_CARGA * ((double)inst.nnz + 2.0 * folhas); }
+
+    // Volta ao estado de iniciar_registro(): inverte os flips anotados, do
+    // último ao primeiro, ou recarrega a solução de então se sair mais barato.
+    void desfazer() {
+        if (recarregado || registro.size() * custo_flip() > custo_carga()) {
+            carregar(sol_registro);
+        } else {
+            for (auto it = registro.rbegin(); it != registro.rend(); ++it) inverter(*it);
+        }
+        confirmar();
+    }
+
+    // Leva o motor à solução 's': inverte só os bits diferentes ou recalcula
+    // tudo, o que custar menos.
+    void mover_para(const Solucao& s) {
+        if (!carregado || distancia_hamming(sol, s) * custo_flip() > custo_carga()) {
+            carregar(s);
+            return;
+        }
+        for (int k = 0; k < sol.num_palavras(); ++k) {
+            for (uint64_t bits = sol.palavras()[k] ^ s.palavras()[k]; bits; bits &= bits - 1) {
+                aplicar((k << 6) | __builtin_ctzll(bits));
+            }
+        }
+    }
+
+    // Itens cujo ganho mudou no último aplicar() (inclui o item invertido).
+    const std::vector<int>& ultimos_alterados() const { return alterados; }
+
+    // Item de maior ganho entre os que cabem e satisfazem admissivel(item), ou -1.
+    template <class Admissivel>
+    int melhor_movimento(Admissivel admissivel) {
+        // Itens fora que cabem: posições [0, limite) na ordem por peso
+        int limite = (int)(std::upper_bound(peso_ordenado.begin(), peso_ordenado.end(), inst.capacidade - somaPeso) -
+                           peso_ordenado.begin());
+        heap.clear();
+        empilhar({DENTRO, 1, 0, folhas}, limite);
+        empilhar({FORA, 1, 0, folhas}, limite);
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), Pior{this});
+            No no = heap.back();
+            heap.pop_back();
+            if (no.largura == 1) {
+                int item = arv[no.arvore][no.k];
+                CONTAR(movimentos_avaliados);
+                if (admissivel(item)) return item;
+                continue;
+            }
+            int metade = no.largura / 2;
+            empilhar({no.arvore, 2 * no.k, no.inicio, metade}, limite);
+            empilhar({no.arvore, 2 * no.k + 1, no.inicio + metade, metade}, limite);
+        }
+        return -1;
+    }
+
+private:
+    // Inverte 'item' e atualiza apenas os ganhos afetados (sem anotar).
+    void inverter(int item) {
+        alterados.clear();
+        long long trabalho = 0;
+        int delta = ganho[item];
+        bool entrando = !sol[item];
+        sol.flip(item);
+        valor += delta;
+        somaPeso += entrando ? inst.peso[item] : -inst.peso[item];
+
+        for (int cj : inst.conjuntos(item)) {
+            int antes = itemsPorConj[cj];
+            int depois = entrando ? antes + 1 : antes - 1;
+            itemsPorConj[cj] = (contador_t)depois;
+
+            int lim = inst.lim_conj[cj];
+            int custo = inst.custo_conj[cj];
+            // Selecionados: cruzou lim <-> lim + 1
+            if (std::max(antes, depois) == lim + 1) {
+                int d = depois > antes ? custo : -custo;
+                for (int x : inst.membros(cj)) {
+                    if (x != item && sol[x]) alterar(x, d);
+                }
+                trabalho += inst.membros(cj).size();
+            }
+            // Fora da solução: cruzou lim - 1 <-> lim
+            if (std::max(antes, depois) == lim) {
+                int d = depois > antes ? -custo : custo;
+                for (int x : inst.membros(cj)) {
+                    if (x != item && !sol[x]) alterar(x, d);
+                }
+                trabalho += inst.membros(cj).size();
+            }
+        }
+        trabalho += inst.conjuntos(item).size() + (long long)(alterados.size() + 1) * niveis;
+        trabalho_flips += trabalho;
+        flips_medidos++;
+        ganho[item] = -delta;
+        int k = folhas + pos[item];
+        arv[entrando ? DENTRO : FORA][k] = item;
+        arv[entrando ? FORA : DENTRO][k] = -1;
+        subir(entrando ? FORA : DENTRO, k);
+        marcar(item);
+
+        for (int x : alterados) {
+            sujo[x] = 0;
+            subir(sol[x] ? DENTRO : FORA, folhas + pos[x]);
+        }
+    }
+
+    enum { DENTRO = 0, FORA = 1 };
+    struct No {
+        int arvore, k, inicio, largura;
+    };
+
+    LayoutVizinhanca layout;
+    std::vector<int> selecao;  // rascunho de avaliar_vizinhanca()
+    ContagemConjuntos contagem;
+    int folhas = 1;
+    std::vector<int> arv[2];  // arv[t][k] = item de maior ganho na subárvore k (-1 = vazia)
+    std::vector<int> pos;     // posição da folha de cada item (ordem por peso)
+    std::vector<int> peso_ordenado;
+    std::vector<char> sujo;
+    std::vector<int> alterados;
+    std::vector<No> heap;
+    std::vector<int> registro;  // itens invertidos desde iniciar_registro()
+    Solucao sol_registro;       // solução em iniciar_registro()
+    bool registrando = false;
+    bool recarregado = false;  // houve carregar() durante o registro
+    bool carregado = false;  // o estado só é consistente depois do primeiro carregar()
+    int niveis = 1;           // altura das árvores
+    long long trabalho_flips = 0, flips_medidos = 0;  // custo observado dos flips (ver custo_flip())
+
+    int melhor(int a, int b) const {
+        if (a == -1) return b;
+        if (b == -1) return a;
+        if (ganho[a] != ganho[b]) return ganho[a] > ganho[b] ? a : b;
+        return a < b ? a : b;
+    }
+
+    // Ordem do heap de melhor_movimento(): o topo é o nó com o melhor item.
+    struct Pior {
+        const MotorGanho* m;
+        bool operator()(const No& a, const No& b) const {
+            int x = m->arv[a.arvore][a.k], y = m->arv[b.arvore][b.k];
+            return x != y && m->melhor(x, y) == y;
+        }
+    };
+
+    void empilhar(No no, int limite) {
+        if (arv[no.arvore][no.k] == -1) return;
+        if (no.arvore == FORA && no.inicio >= limite) return;
+        heap.push_back(no);
+        std::push_heap(heap.begin(), heap.end(), Pior{this});
+    }
+
+    void subir(int t, int k) {
+        for (k >>= 1; k >= 1; k >>= 1) arv[t][k] = melhor(arv[t][2 * k], arv[t][2 * k + 1]);
+    }
+
+    void alterar(int x, int d) {
+        ganho[x] += d;
+        marcar(x);
+    }
+
+    void marcar(int x) {
+        if (!sujo[x]) {
+            sujo[x] = 1;
+            alterados.push_back(x);
+        }
+    }
+};
@@ -0,0 +1,813 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#include "kpfs.h"
+#include "solucao.h"
+#include "avaliacao.h"
+#include "memoria_tabu.h"
+#include "busca_local.h"
+#include "vizinhanca.h"
+#include "simulated_annealing.h"
+
+using namespace std;
+
+// --- Microbenchmarks ---
+// delta: compara o layout antigo (vector<vector<int>> + vector<pair<int,int>>) com
+//        o layout CSR/SoA de kpfs.h, varrendo a vizinhança completa de flip (como
+//        no laço interno do TABU_Optimized) sobre as instâncias de 1000 itens.
+// carga: tempo de leitura de todas as instâncias com ifstream (antigo), com
+//        mmap + from_chars e pelo formato binário .kpfsb.
+// tabu:  iterações/s de uma busca tabu simples (melhor movimento admissível da
+//        vizinhança completa) recalculando os deltas a cada iteração, escalar e
+//        com avaliar_vizinhanca() + filtro tabu à parte, x MotorGanho, nas
+//        instâncias de 1000 itens do cenário 4.
+// memoria: iterações/s e memória da busca tabu com std::map, tabela hash e
+//        tabu por atributo, nas mesmas instâncias.
+// lote:  confere EstadoSA::deltas_lote() (AVX2 se houver) contra delta() em
+//        estados aleatórios, depois de flips aleatórios, e o currentValue
+//        mantido contra a reavaliação do zero, nas instâncias de 1000 itens;
+//        sai com código 1 se divergir. A suite roda essa conferência antes de
+//        medir.
+// suite: mede os núcleos de avaliação em cada tamanho (300 a 1000 itens) e
+//        grava JSON, uma medida por linha:
+//          carga               leitura do texto (op = instância)
+//          avaliacao_completa  MotorGanho::carregar (op = solução avaliada do zero)
+//          delta               ganho de um flip, percorrendo os conjuntos do item
+//          varredura           vizinhança completa do TABU_Optimized (op = varredura)
+//          varredura_vetorial  a mesma com avaliar_vizinhanca() (SIMD se houver)
+//          aplicar             flip com atualização incremental dos ganhos
+//          busca_local         descida completa de FastLocalSearch (op = descida)
+//        ns_op é o melhor de REPETICOES_SUITE tomadas; mov_s são movimentos
+//        avaliados ou aplicados por segundo (0 quando não se aplica).
+// comparar: compara dois JSON da suite e marca como regressão toda medida cujo
+//        ns_op piorou mais que o limiar (padrão 10%); sai com código 1 se houver.
+//
+// Uso: ./benchmark [delta|carga|tabu|memoria|lote] [diretorio_instancias]
+//      ./benchmark suite [diretorio_instancias] [saida.json]
+//      ./benchmark comparar <base.json> <atual.json> [limiar_%]
+
+const int SOLUCOES_POR_INSTANCIA = 20;
+const int VARREDURAS_POR_SOLUCAO = 50;
+const int REPETICOES_CARGA = 3;
+const int ITERACOES_TABU = 3000;
+const int TENURE_BENCH = 10;
+const int ITERACOES_MEMORIA = 10000;
+const int RODADAS_LOTE = 20000;  // lotes conferidos por instância
+const int REPETICOES_SUITE = 5;
+const double TEMPO_MINIMO_SUITE = 0.05;  // segundos por tomada
+const double LIMIAR_REGRESSAO = 10.0;    // %
+
+vector<string> listar_instancias(const string& raiz, const string& tamanho = "") {
+    vector<string> arquivos;
+    for (const auto& entrada : filesystem::recursive_directory_iterator(raiz)) {
+        const filesystem::path& p = entrada.path();
+        if (!entrada.is_regular_file() || p.extension() != ".txt" || p.filename().string().rfind("kpfs_", 0) != 0) continue;
+        if (!tamanho.empty() && p.parent_path().filename() != tamanho) continue;
+        arquivos.push_back(p.string());
+    }
+    sort(arquivos.begin(), arquivos.end());
+    return arquivos;
+}
+
+vector<string> instancias_cenario4(const string& raiz) {
+    vector<string> arquivos;
+    for (const string& caminho : listar_instancias(raiz, "1000")) {
+        if (caminho.find("scenario4") != string::npos) arquivos.push_back(caminho);
+    }
+    return arquivos;
+}
+
+struct LayoutAntigo {
+    vector<vector<int>> conju;
+    vector<pair<int, int>> inf_conj;
+    vector<int> itemsPorConj;
+};
+
+LayoutAntigo montar_layout_antigo(const Instancia& inst) {
+    LayoutAntigo antigo;
+    antigo.conju.assign(inst.itens, vector<int>());
+    antigo.inf_conj.resize(inst.quant_conj);
+    for (int j = 0; j < inst.quant_conj; ++j) {
+        antigo.inf_conj[j] = {inst.lim_conj[j], inst.custo_conj[j]};
+        for (int item : inst.membros(j)) antigo.conju[item].push_back(j);
+    }
+    antigo.itemsPorConj.assign(inst.quant_conj, 0);
+    return antigo;
+}
+
+long long varrer_antigo(const Instancia& inst, const LayoutAntigo& antigo, const vector<char>& sol, int somaPeso) {
+    long long soma = 0;
+    for (int itemFlip = 0; itemFlip < inst.itens; ++itemFlip) {
+        int delta = 0;
+        if (sol[itemFlip]) {
+            delta = -inst.lucro[itemFlip];
+            for (int cj : antigo.conju[itemFlip]) {
+                if (antigo.itemsPorConj[cj] > antigo.inf_conj[cj].first) delta += antigo.inf_conj[cj].second;
+            }
+        } else {
+            if (somaPeso + inst.peso[itemFlip] > inst.capacidade) continue;
+            delta = inst.lucro[itemFlip];
+            for (int cj : antigo.conju[itemFlip]) {
+                if (antigo.itemsPorConj[cj] + 1 > antigo.inf_conj[cj].first) delta -= antigo.inf_conj[cj].second;
+            }
+        }
+        soma += delta;
+    }
+    return soma;
+}
+
+long long varrer_csr(const Instancia& inst, const vector<contador_t>& itemsPorConj, const vector<char>& sol, int somaPeso) {
+    long long soma = 0;
+    for (int itemFlip = 0; itemFlip < inst.itens; ++itemFlip) {
+        int delta = 0;
+        if (sol[itemFlip]) {
+            delta = -inst.lucro[itemFlip];
+            for (int cj : inst.conjuntos(itemFlip)) {
+                if (itemsPorConj[cj] > inst.lim_conj[cj]) delta += inst.custo_conj[cj];
+            }
+        } else {
+            if (somaPeso + inst.peso[itemFlip] > inst.capacidade) continue;
+            delta = inst.lucro[itemFlip];
+            for (int cj : inst.conjuntos(itemFlip)) {
+                if (itemsPorConj[cj] + 1 > inst.lim_conj[cj]) delta -= inst.custo_conj[cj];
+            }
+        }
+        soma += delta;
+    }
+    return soma;
+}
+
+int bench_delta(const string& raiz) {
+    vector<string> arquivos = listar_instancias(raiz, "1000");
+    if (arquivos.empty()) {
+        cerr << "Nenhuma instancia de 1000 itens encontrada em " << raiz << endl;
+        return 1;
+    }
+
+    mt19937_64 rng(12345);
+    double tempo_antigo = 0, tempo_csr = 0;
+    long long avaliacoes = 0;
+
+    for (const string& caminho : arquivos) {
+        Instancia inst;
+        if (!carregar_instancia(caminho, inst)) {
+            cerr << "Erro ao abrir o arquivo: " << caminho << endl;
+            return 1;
+        }
+        LayoutAntigo antigo = montar_layout_antigo(inst);
+        vector<contador_t> itemsPorConj(inst.quant_conj, 0);
+
+        for (int s = 0; s < SOLUCOES_POR_INSTANCIA; ++s) {
+            // Solução aleatória viável em peso
+            vector<char> sol(inst.itens, 0);
+            vector<int> ordem(inst.itens);
+            for (int i = 0; i < inst.itens; ++i) ordem[i] = i;
+            shuffle(ordem.begin(), ordem.end(), rng);
+            int somaPeso = 0;
+            fill(itemsPorConj.begin(), itemsPorConj.end(), 0);
+            fill(antigo.itemsPorConj.begin(), antigo.itemsPorConj.end(), 0);
+            for (int item : ordem) {
+                if (somaPeso + inst.peso[item] > inst.capacidade) continue;
+                sol[item] = 1;
+                somaPeso += inst.peso[item];
+                for (int cj : inst.conjuntos(item)) {
+                    itemsPorConj[cj]++;
+                    antigo.itemsPorConj[cj]++;
+                }
+            }
+
+            long long ref_antigo = 0, ref_csr = 0;
+            auto t0 = chrono::high_resolution_clock::now();
+            for (int r = 0; r < VARREDURAS_POR_SOLUCAO; ++r) ref_antigo += varrer_antigo(inst, antigo, sol, somaPeso);
+            auto t1 = chrono::high_resolution_clock::now();
+            for (int r = 0; r < VARREDURAS_POR_SOLUCAO; ++r) ref_csr += varrer_csr(inst, itemsPorConj, sol, somaPeso);
+            auto t2 = chrono::high_resolution_clock::now();
+
+            if (ref_antigo != ref_csr) {
+                cerr << "Divergencia entre layouts em " << caminho << endl;
+                return 1;
+            }
+            tempo_antigo += chrono::duration<double>(t1 - t0).count();
+            tempo_csr += chrono::duration<double>(t2 - t1).count();
+            avaliacoes += (long long)VARREDURAS_POR_SOLUCAO * inst.itens;
+        }
+    }
+
+    cout << fixed << setprecision(2);
+    cout << "Instancias: " << arquivos.size() << " | avaliacoes de delta por layout: " << avaliacoes << "\n";
+    cout << "  vector<vector<int>> : " << setw(8) << avaliacoes / tempo_antigo / 1e6 << " M deltas/s\n";
+    cout << "  CSR + SoA           : " << setw(8) << avaliacoes / tempo_csr / 1e6 << " M deltas/s\n";
+    cout << "  ganho               : " << setw(8) << tempo_antigo / tempo_csr << "x\n";
+    return 0;
+}
+
+// Leitura token a token com ifstream, como era feita no main de cada algoritmo.
+bool carregar_ifstream(const string& caminho, LayoutAntigo& antigo, vector<int>& lucro, vector<int>& peso) {
+    ifstream arquivo(caminho);
+    if (!arquivo.is_open()) return false;
+    int itens, quant_conj, capacidade;
+    arquivo >> itens >> quant_conj >> capacidade;
+    lucro.assign(itens, 0);
+    peso.assign(itens, 0);
+    for (int j = 0; j < itens; j++) arquivo >> lucro[j];
+    for (int j = 0; j < itens; j++) arquivo >> peso[j];
+    antigo.conju.assign(itens, vector<int>());
+    antigo.inf_conj.assign(quant_conj, make_pair(0, 0));
+    for (int j = 0; j < quant_conj; j++) {
+        int lim_conj, penalidade_conj, itens_conj;
+        arquivo >> lim_conj >> penalidade_conj >> itens_conj;
+        antigo.inf_conj[j] = {lim_conj, penalidade_conj};
+        for (int k = 0; k < itens_conj; k++) {
+            int item;
+            arquivo >> item;
+            antigo.conju[item].push_back(j);
+        }
+    }
+    return (bool)arquivo;
+}
+
+int bench_carga(const string& raiz) {
+    vector<string> arquivos = listar_instancias(raiz);
+    if (arquivos.empty()) {
+        cerr << "Nenhuma instancia encontrada em " << raiz << endl;
+        return 1;
+    }
+
+    // Converte tudo para .kpfsb num diretório temporário
+    filesystem::path dir_bin = filesystem::temp_directory_path() / "kpfsb_benchmark";
+    filesystem::create_directories(dir_bin);
+    vector<string> binarios;
+    for (size_t i = 0; i < arquivos.size(); ++i) {
+        Instancia inst, copia;
+        string destino = (dir_bin / (to_string(i) + ".kpfsb")).string();
+        if (!carregar_instancia_texto(arquivos[i], inst) || !salvar_instancia_binaria(inst, destino) ||
+            !carregar_instancia_binaria(destino, copia) ||
+            !equal(inst.bloco(), inst.bloco() + inst.tamanho_bloco(), copia.bloco())) {
+            cerr << "Erro ao converter " << arquivos[i] << endl;
+            return 1;
+        }
+        binarios.push_back(destino);
+    }
+
+    double t_ifstream = 0, t_texto = 0, t_binario = 0;
+    long long soma_ifstream = 0, soma_texto = 0, soma_binario = 0;
+    for (int r = 0; r < REPETICOES_CARGA; ++r) {
+        auto t0 = chrono::high_resolution_clock::now();
+        for (const string& caminho : arquivos) {
+            LayoutAntigo antigo;
+            vector<int> lucro, peso;
+            if (!carregar_ifstream(caminho, antigo, lucro, peso)) return 1;
+            soma_ifstream += (long long)antigo.inf_conj.size() + lucro.size();
+        }
+        auto t1 = chrono::high_resolution_clock::now();
+        for (const string& caminho : arquivos) {
+            Instancia inst;
+            if (!carregar_instancia_texto(caminho, inst)) return 1;
+            soma_texto += inst.quant_conj + inst.itens;
+        }
+        auto t2 = chrono::high_resolution_clock::now();
+        for (const string& caminho : binarios) {
+            Instancia inst;
+            if (!carregar_instancia_binaria(caminho, inst)) return 1;
+            soma_binario += inst.quant_conj + inst.itens;
+        }
+        auto t3 = chrono::high_resolution_clock::now();
+        t_ifstream += chrono::duration<double>(t1 - t0).count();
+        t_texto += chrono::duration<double>(t2 - t1).count();
+        t_binario += chrono::duration<double>(t3 - t2).count();
+    }
+    filesystem::remove_all(dir_bin);
+    if (soma_ifstream != soma_texto || soma_texto != soma_binario) {
+        cerr << "Divergencia entre leitores" << endl;
+        return 1;
+    }
+
+    double n = (double)arquivos.size() * REPETICOES_CARGA;
+    cout << fixed << setprecision(1);
+    cout << "Instancias: " << arquivos.size() << " | repeticoes: " << REPETICOES_CARGA << "\n";
+    cout << "  ifstream >>         : " << setw(8) << t_ifstream / n * 1e6 << " us/instancia\n";
+    cout << "  mmap + from_chars   : " << setw(8) << t_texto / n * 1e6 << " us/instancia\n";
+    cout << "  binario .kpfsb      : " << setw(8) << t_binario / n * 1e6 << " us/instancia\n";
+    return 0;
+}
+
+// Busca tabu por atributo recalculando todos os deltas; devolve a sequência de itens.
+vector<int> tabu_varredura(const Instancia& inst) {
+    vector<char> sol(inst.itens, 0);
+    vector<contador_t> itemsPorConj(inst.quant_conj, 0);
+    vector<int> tabu_ate(inst.itens, 0), movimentos;
+    int somaPeso = 0;
+    for (int iter = 1; iter <= ITERACOES_TABU; ++iter) {
+        int best_item = -1, best_delta = 0;
+        for (int itemFlip = 0; itemFlip < inst.itens; ++itemFlip) {
+            if (tabu_ate[itemFlip] > iter) continue;
+            int delta = 0;
+            if (sol[itemFlip]) {
+                delta = -inst.lucro[itemFlip];
+                for (int cj : inst.conjuntos(itemFlip)) {
+                    if (itemsPorConj[cj] > inst.lim_conj[cj]) delta += inst.custo_conj[cj];
+                }
+            } else {
+                if (somaPeso + inst.peso[itemFlip] > inst.capacidade) continue;
+                delta = inst.lucro[itemFlip];
+                for (int cj : inst.conjuntos(itemFlip)) {
+                    if (itemsPorConj[cj] + 1 > inst.lim_conj[cj]) delta -= inst.custo_conj[cj];
+                }
+            }
+            if (best_item == -1 || delta > best_delta) {
+                best_item = itemFlip;
+                best_delta = delta;
+            }
+        }
+        if (best_item == -1) break;
+        sol[best_item] ^= 1;
+        int d = sol[best_item] ? 1 : -1;
+        somaPeso += d * inst.peso[best_item];
+        for (int cj : inst.conjuntos(best_item)) itemsPorConj[cj] += d;
+        tabu_ate[best_item] = iter + TENURE_BENCH;
+        movimentos.push_back(best_item);
+    }
+    return movimentos;
+}
+
+// A mesma busca, com a vizinhança calculada por avaliar_vizinhanca() e o filtro
+// tabu aplicado depois, numa passada separada.
+vector<int> tabu_vetorial(const Instancia& inst, const LayoutVizinhanca& layout) {
+    vector<char> sol(inst.itens, 0), cabe(inst.itens);
+    vector<contador_t> itemsPorConj(inst.quant_conj, 0);
+    vector<int> tabu_ate(inst.itens, 0), ganho(inst.itens), movimentos, selecao;
+    int somaPeso = 0;
+    for (int iter = 1; iter <= ITERACOES_TABU; ++iter) {
+        avaliar_vizinhanca(inst, layout, sol, itemsPorConj, somaPeso, ganho.data(), cabe.data(), selecao);
+        int best_item = -1, best_delta = 0;
+        for (int itemFlip = 0; itemFlip < inst.itens; ++itemFlip) {
+            if (tabu_ate[itemFlip] > iter || !cabe[itemFlip]) continue;
+            if (best_item == -1 || ganho[itemFlip] > best_delta) {
+                best_item = itemFlip;
+                best_delta = ganho[itemFlip];
+            }
+        }
+        if (best_item == -1) break;
+        sol[best_item] ^= 1;
+        int d = sol[best_item] ? 1 : -1;
+        somaPeso += d * inst.peso[best_item];
+        for (int cj : inst.conjuntos(best_item)) itemsPorConj[cj] += d;
+        tabu_ate[best_item] = iter + TENURE_BENCH;
+        movimentos.push_back(best_item);
+    }
+    return movimentos;
+}
+
+vector<int> tabu_motor(const Instancia& inst) {
+    MotorGanho<SolucaoFixa<1024>> motor(inst);
+    motor.carregar(SolucaoFixa<1024>(inst.itens));
+    vector<int> tabu_ate(inst.itens, 0), movimentos;
+    for (int iter = 1; iter <= ITERACOES_TABU; ++iter) {
+        int best_item = motor.melhor_movimento([&](int item) { return tabu_ate[item] <= iter; });
+        if (best_item == -1) break;
+        motor.aplicar(best_item);
+        tabu_ate[best_item] = iter + TENURE_BENCH;
+        movimentos.push_back(best_item);
+    }
+    return movimentos;
+}
+
+int bench_tabu(const string& raiz) {
+    vector<string> arquivos = instancias_cenario4(raiz);
+    if (arquivos.empty()) {
+        cerr << "Nenhuma instancia de 1000 itens do cenario 4 encontrada em " << raiz << endl;
+        return 1;
+    }
+
+    double t_varredura = 0, t_vetorial = 0, t_motor = 0;
+    long long iteracoes = 0;
+    for (const string& caminho : arquivos) {
+        Instancia inst;
+        if (!carregar_instancia(caminho, inst) || inst.itens > 1024) {
+            cerr << "Erro ao abrir o arquivo: " << caminho << endl;
+            return 1;
+        }
+        auto t0 = chrono::high_resolution_clock::now();
+        vector<int> a = tabu_varredura(inst);
+        auto t1 = chrono::high_resolution_clock::now();
+        vector<int> b = tabu_motor(inst);
+        auto t2 = chrono::high_resolution_clock::now();
+        LayoutVizinhanca layout(inst);
+        auto t3 = chrono::high_resolution_clock::now();
+        vector<int> c = tabu_vetorial(inst, layout);
+        auto t4 = chrono::high_resolution_clock::now();
+        if (a != b || a != c) {
+            cerr << "Divergencia entre trajetorias em " << caminho << endl;
+            return 1;
+        }
+        t_varredura += chrono::duration<double>(t1 - t0).count();
+        t_motor += chrono::duration<double>(t2 - t1).count();
+        t_vetorial += chrono::duration<double>(t4 - t3).count();
+        iteracoes += a.size();
+    }
+
+    cout << fixed << setprecision(0);
+    cout << "Instancias: " << arquivos.size() << " | iteracoes por versao: " << iteracoes << "\n";
+    cout << "  varredura completa  : " << setw(10) << iteracoes / t_varredura << " iter/s\n";
+    cout << "  varredura vetorial  : " << setw(10) << iteracoes / t_vetorial << " iter/s"
+         << (cpu_tem_avx512() ? " (AVX-512)" : cpu_tem_avx2() ? " (AVX2)" : " (escalar)") << "\n";
+    cout << "  MotorGanho          : " << setw(10) << iteracoes / t_motor << " iter/s\n";
+    cout << setprecision(2) << "  ganho               : " << setw(10) << t_varredura / t_motor << "x\n";
+    return 0;
+}
+
+// Laço do TABU_Optimized (aspiração + memória) por um número fixo de iterações.
+template <class Memoria>
+vector<int> tabu_com_memoria(const Instancia& inst, int tenure, size_t& bytes) {
+    MotorGanho<SolucaoFixa<1024>> motor(inst);
+    motor.carregar(SolucaoFixa<1024>(inst.itens));
+    Memoria memoria(inst.itens, tenure);
+    mt19937_64 gerador(777);
+    vector<long long> rand_int(inst.itens);
+    for (long long& r : rand_int) r = (long long)(gerador() >> 4);
+
+    long long chash = 0;
+    int bestValue = motor.valor;
+    memoria.registrar(chash, -1, 0);
+    vector<int> movimentos;
+    for (int iter = 1; iter <= ITERACOES_MEMORIA; ++iter) {
+        int item = motor.melhor_movimento([&](int i) {
+            if (motor.valor + motor.ganho[i] > bestValue) return true;
+            return !memoria.tabu(chash ^ rand_int[i], i, iter);
+        });
+        if (item == -1) break;
+        motor.aplicar(item);
+        bestValue = max(bestValue, motor.valor);
+        chash ^= rand_int[item];
+        memoria.registrar(chash, item, iter);
+        movimentos.push_back(item);
+    }
+    bytes = memoria.bytes();
+    return movimentos;
+}
+
+int bench_memoria(const string& raiz) {
+    vector<string> arquivos = instancias_cenario4(raiz);
+    if (arquivos.empty()) {
+        cerr << "Nenhuma instancia de 1000 itens do cenario 4 encontrada em " << raiz << endl;
+        return 1;
+    }
+
+    const char* nomes[3] = {"std::map", "hash (end. aberto)", "atributo"};
+    double tempo[3] = {0, 0, 0};
+    long long iteracoes[3] = {0, 0, 0};
+    size_t maior_memoria[3] = {0, 0, 0};
+    for (const string& caminho : arquivos) {
+        Instancia inst;
+        if (!carregar_instancia(caminho, inst) || inst.itens > 1024) {
+            cerr << "Erro ao abrir o arquivo: " << caminho << endl;
+            return 1;
+        }
+        vector<int> trajetorias[3];
+        size_t bytes[3];
+        auto t0 = chrono::high_resolution_clock::now();
+        trajetorias[0] = tabu_com_memoria<MemoriaTabuMap>(inst, 100, bytes[0]);
+        auto t1 = chrono::high_resolution_clock::now();
+        trajetorias[1] = tabu_com_memoria<MemoriaTabuHash>(inst, 100, bytes[1]);
+        auto t2 = chrono::high_resolution_clock::now();
+        trajetorias[2] = tabu_com_memoria<MemoriaTabuAtributo>(inst, 20, bytes[2]);
+        auto t3 = chrono::high_resolution_clock::now();
+
+        // map e hash guardam a mesma informação: a trajetória deve ser idêntica
+        if (trajetorias[0] != trajetorias[1]) {
+            cerr << "Divergencia entre map e hash em " << caminho << endl;
+            return 1;
+        }
+        double t[3] = {chrono::duration<double>(t1 - t0).count(), chrono::duration<double>(t2 - t1).count(),
+                       chrono::duration<double>(t3 - t2).count()};
+        for (int k = 0; k < 3; ++k) {
+            tempo[k] += t[k];
+            iteracoes[k] += trajetorias[k].size();
+            maior_memoria[k] = max(maior_memoria[k], bytes[k]);
+        }
+    }
+
+    cout << "Instancias: " << arquivos.size() << " | ate " << ITERACOES_MEMORIA << " iteracoes cada\n";
+    for (int k = 0; k < 3; ++k) {
+        cout << "  " << left << setw(20) << nomes[k] << right << ": " << fixed << setprecision(0) << setw(10)
+             << iteracoes[k] / tempo[k] << " iter/s | " << setw(8) << maior_memoria[k] / 1024.0 << " KiB\n";
+    }
+    return 0;
+}
+
+// --- Suite com saída JSON ---
+
+struct Medida {
+    string nome;
+    int tamanho;
+    double ns_op;
+    double mov_s;
+};
+
+// Chama rodada() (que devolve quantas operações fez) até somar TEMPO_MINIMO_SUITE
+// e devolve o melhor ns/op entre REPETICOES_SUITE tomadas.
+template <class Rodada>
+double medir_ns_op(Rodada rodada) {
+    double melhor = 1e300;
+    for (int r = 0; r < REPETICOES_SUITE; ++r) {
+        long long ops = 0;
+        double decorrido = 0;
+        auto t0 = chrono::high_resolution_clock::now();
+        while (decorrido < TEMPO_MINIMO_SUITE) {
+            ops += rodada();
+            decorrido = chrono::duration<double>(chrono::high_resolution_clock::now() - t0).count();
+        }
+        melhor = min(melhor, decorrido * 1e9 / max(ops, 1LL));
+    }
+    return melhor;
+}
+
+long long volatile sumidouro;  // impede que o compilador descarte os resultados
+
+template <class Solucao>
+void suite_tamanho(const vector<string>& arquivos, int tamanho, vector<Medida>& medidas) {
+    vector<unique_ptr<Instancia>> instancias;
+    for (const string& caminho : arquivos) {
+        instancias.push_back(make_unique<Instancia>());
+        if (!carregar_instancia(caminho, *instancias.back())) {
+            cerr << "Erro ao abrir o arquivo: " << caminho << endl;
+            instancias.pop_back();
+        }
+    }
+    if (instancias.empty()) return;
+    long long itens_total = 0;
+    for (const auto& inst : instancias) itens_total += inst->itens;
+
+    // Uma solução aleatória viável em peso por instância, sempre a mesma
+    mt19937_64 rng(12345);
+    vector<Solucao> solucoes;
+    for (const auto& inst : instancias) {
+        Solucao sol(inst->itens);
+        vector<int> ordem(inst->itens);
+        for (int i = 0; i < inst->itens; ++i) ordem[i] = i;
+        shuffle(ordem.begin(), ordem.end(), rng);
+        int somaPeso = 0;
+        for (int item : ordem) {
+            if (somaPeso + inst->peso[item] > inst->capacidade) continue;
+            sol.set(item);
+            somaPeso += inst->peso[item];
+        }
+        solucoes.push_back(sol);
+    }
+    vector<unique_ptr<MotorGanho<Solucao>>> motores;
+    for (size_t k = 0; k < instancias.size(); ++k) {
+        motores.push_back(make_unique<MotorGanho<Solucao>>(*instancias[k]));
+        motores.back()->carregar(solucoes[k]);
+    }
+    const long long n = (long long)instancias.size();
+
+    double ns = medir_ns_op([&] {
+        for (const string& caminho : arquivos) {
+            Instancia inst;
+            carregar_instancia_texto(caminho, inst);
+            sumidouro = inst.nnz;
+        }
+        return (long long)arquivos.size();
+    });
+    medidas.push_back({"carga", tamanho, ns, 0});
+
+    ns = medir_ns_op([&] {
+        for (long long k = 0; k < n; ++k) {
+            motores[k]->carregar(solucoes[k]);
+            sumidouro = motores[k]->valor;
+        }
+        return n;
+    });
+    medidas.push_back({"avaliacao_completa", tamanho, ns, 0});
+
+    ns = medir_ns_op([&] {
+        long long soma = 0;
+        for (long long k = 0; k < n; ++k) {
+            for (int i = 0; i < instancias[k]->itens; ++i) soma += motores[k]->calcular_ganho(i);
+        }
+        sumidouro = soma;
+        return itens_total;
+    });
+    medidas.push_back({"delta", tamanho, ns, 1e9 / ns});
+
+    vector<vector<char>> sol_char(n);
+    for (long long k = 0; k < n; ++k) {
+        sol_char[k].resize(instancias[k]->itens);
+        for (int i = 0; i < instancias[k]->itens; ++i) sol_char[k][i] = solucoes[k][i];
+    }
+    ns = medir_ns_op([&] {
+        long long soma = 0;
+        for (long long k = 0; k < n; ++k) soma += varrer_csr(*instancias[k], motores[k]->itemsPorConj, sol_char[k], motores[k]->somaPeso);
+        sumidouro = soma;
+        return n;
+    });
+    medidas.push_back({"varredura", tamanho, ns, 1e9 / ns * itens_total / n});
+
+    vector<unique_ptr<LayoutVizinhanca>> layouts;
+    for (const auto& inst : instancias) layouts.push_back(make_unique<LayoutVizinhanca>(*inst));
+    vector<int> ganhos, selecao;
+    vector<char> cabe;
+    ns = medir_ns_op([&] {
+        long long soma = 0;
+        for (long long k = 0; k < n; ++k) {
+            ganhos.resize(instancias[k]->itens);
+            cabe.resize(instancias[k]->itens);
+            avaliar_vizinhanca(*instancias[k], *layouts[k], sol_char[k], motores[k]->itemsPorConj, motores[k]->somaPeso,
+                               ganhos.data(), cabe.data(), selecao);
+            for (int i = 0; i < instancias[k]->itens; ++i) soma += cabe[i] ? ganhos[i] : 0;
+        }
+        sumidouro = soma;
+        return n;
+    });
+    medidas.push_back({"varredura_vetorial", tamanho, ns, 1e9 / ns * itens_total / n});
+
+    vector<vector<int>> flips(n);
+    for (long long k = 0; k < n; ++k) {
+        uniform_int_distribution<int> item_dist(0, instancias[k]->itens - 1);
+        for (int f = 0; f < 256; ++f) flips[k].push_back(item_dist(rng));
+    }
+    ns = medir_ns_op([&] {
+        for (long long k = 0; k < n; ++k) {
+            for (int item : flips[k]) motores[k]->aplicar(item);
+            sumidouro = motores[k]->valor;
+        }
+        return n * 256;
+    });
+    medidas.push_back({"aplicar", tamanho, ns, 1e9 / ns});
+
+    vector<unique_ptr<BuscaLocal<ModoBuscaLocal::Primeira>>> buscas;
+    for (const auto& inst : instancias) buscas.push_back(make_unique<BuscaLocal<ModoBuscaLocal::Primeira>>(inst->itens));
+    ns = medir_ns_op([&] {
+        for (long long k = 0; k < n; ++k) {
+            motores[k]->carregar(solucoes[k]);
+            FastLocalSearch(*motores[k], *buscas[k]);
+            sumidouro = motores[k]->valor;
+        }
+        return n;
+    });
+    medidas.push_back({"busca_local", tamanho, ns, 0});
+}
+
+string medidas_json(const vector<Medida>& medidas) {
+    ostringstream out;
+    out << "{\n  \"versao\": 1,\n  \"medidas\": [\n";
+    for (size_t k = 0; k < medidas.size(); ++k) {
+        const Medida& m = medidas[k];
+        out << "    {\"nome\": \"" << m.nome << "\", \"tamanho\": " << m.tamanho << ", \"ns_op\": " << fixed
+            << setprecision(2) << m.ns_op << ", \"mov_s\": " << setprecision(0) << m.mov_s << "}"
+            << (k + 1 < medidas.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+template <class Solucao>
+long long conferir_lote_instancia(const Instancia& inst, mt19937_64& rng, long long& lotes) {
+    EstadoSA<Solucao> estado(inst);
+    estado.iniciar(rng);
+    uniform_int_distribution<int> item_dist(0, inst.itens - 1);
+    long long divergencias = 0;
+    int itens[LOTE_SA], deltas[LOTE_SA];
+    for (int rodada = 0; rodada < RODADAS_LOTE; ++rodada) {
+        for (int& item : itens) item = item_dist(rng);
+        estado.deltas_lote(itens, deltas);
+        for (int k = 0; k < LOTE_SA; ++k) divergencias += deltas[k] != estado.delta(itens[k]);
+        lotes++;
+        // Um flip aleatório (viável) leva a outro estado.
+        int item = item_dist(rng), d = estado.delta(item);
+        if (d != INT_MIN) estado.aplicar(item, d);
+    }
+    return divergencias + (estado.currentValue != estado.reavaliar());
+}
+
+int bench_lote(const string& raiz) {
+    vector<string> arquivos = listar_instancias(raiz, "1000");
+    if (arquivos.empty()) {
+        cerr << "Nenhuma instancia de 1000 itens encontrada em " << raiz << endl;
+        return 1;
+    }
+    mt19937_64 rng(42);
+    long long lotes = 0;
+    for (const string& caminho : arquivos) {
+        Instancia inst;
+        if (!carregar_instancia(caminho, inst)) {
+            cerr << "Erro ao abrir o arquivo: " << caminho << endl;
+            return 1;
+        }
+        long long divergencias = com_solucao(inst.itens, [&](auto t) {
+            return conferir_lote_instancia<typename decltype(t)::type>(inst, rng, lotes);
+        });
+        if (divergencias) {
+            cerr << "Divergencia entre deltas_lote e delta em " << caminho << ": " << divergencias << endl;
+            return 1;
+        }
+    }
+    cerr << "deltas_lote" << (cpu_tem_avx2() ? " (AVX2)" : " (escalar)") << " confere com delta: " << arquivos.size()
+         << " instancias, " << lotes << " lotes\n";
+    return 0;
+}
+
+int bench_suite(const string& raiz, const string& saida) {
+    if (bench_lote(raiz) != 0) return 1;
+    vector<Medida> medidas;
+    for (const char* tamanho : {"300", "500", "700", "800", "1000"}) {
+        vector<string> arquivos = listar_instancias(raiz, tamanho);
+        if (arquivos.empty()) continue;
+        Instancia primeira;
+        if (!carregar_instancia(arquivos[0], primeira)) {
+            cerr << "Erro ao abrir o arquivo: " << arquivos[0] << endl;
+            return 1;
+        }
+        com_solucao(primeira.itens, [&](auto t) {
+            suite_tamanho<typename decltype(t)::type>(arquivos, stoi(tamanho), medidas);
+            return 0;
+        });
+        cerr << "  tamanho " << tamanho << ": " << arquivos.size() << " instancias medidas\n";
+    }
+    if (medidas.empty()) {
+        cerr << "Nenhuma instancia encontrada em " << raiz << endl;
+        return 1;
+    }
+
+    string json = medidas_json(medidas);
+    if (saida.empty()) {
+        cout << json;
+        return 0;
+    }
+    ofstream arquivo(saida);
+    arquivo << json;
+    if (!arquivo) {
+        cerr << "Erro ao escrever " << saida << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Lê o JSON gerado por medidas_json (uma medida por linha).
+bool ler_medidas_json(const string& caminho, vector<Medida>& medidas) {
+    ifstream arquivo(caminho);
+    if (!arquivo.is_open()) return false;
+    auto valor = [](const string& linha, const string& chave) {
+        size_t p = linha.find("\"" + chave + "\":");
+        if (p == string::npos) return string();
+        p = linha.find_first_not_of(" \"", p + chave.size() + 3);
+        size_t fim = linha.find_first_of(",}\"", p);
+        return linha.substr(p, fim - p);
+    };
+    string linha;
+    while (getline(arquivo, linha)) {
+        if (linha.find("\"nome\"") == string::npos) continue;
+        medidas.push_back({valor(linha, "nome"), stoi(valor(linha, "tamanho")), stod(valor(linha, "ns_op")),
+                           stod(valor(linha, "mov_s"))});
+    }
+    return true;
+}
+
+int bench_comparar(const string& base, const string& atual, double limiar) {
+    vector<Medida> antes, depois;
+    if (!ler_medidas_json(base, antes) || !ler_medidas_json(atual, depois)) {
+        cerr << "Erro ao ler " << base << " ou " << atual << endl;
+        return 1;
+    }
+    int regressoes = 0;
+    cout << left << setw(20) << "medida" << right << setw(8) << "itens" << setw(14) << "base ns/op" << setw(14)
+         << "atual ns/op" << setw(10) << "var." << "\n";
+    for (const Medida& d : depois) {
+        auto a = find_if(antes.begin(), antes.end(), [&](const Medida& m) { return m.nome == d.nome && m.tamanho == d.tamanho; });
+        if (a == antes.end()) continue;
+        double variacao = (d.ns_op / a->ns_op - 1) * 100;
+        bool regressao = variacao > limiar;
+        regressoes += regressao;
+        cout << left << setw(20) << d.nome << right << setw(8) << d.tamanho << fixed << setprecision(1) << setw(14)
+             << a->ns_op << setw(14) << d.ns_op << setw(9) << showpos << variacao << noshowpos << "%"
+             << (regressao ? "  REGRESSAO" : "") << "\n";
+    }
+    cout << regressoes << " regressao(oes) acima de " << limiar << "%\n";
+    return regressoes > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    string modo = argc > 1 ? argv[1] : "delta";
+    string raiz = argc > 2 ? argv[2] : "instances";
+    if (modo == "delta") return bench_delta(raiz);
+    if (modo == "carga") return bench_carga(raiz);
+    if (modo == "tabu") return bench_tabu(raiz);
+    if (modo == "memoria") return bench_memoria(raiz);
+    if (modo == "lote") return bench_lote(raiz);
+    if (modo == "suite") return bench_suite(raiz, argc > 3 ? argv[3] : "");
+    if (modo == "comparar" && argc >= 4) return bench_comparar(argv[2], argv[3], argc > 4 ? atof(argv[4]) : LIMIAR_REGRESSAO);
+    cerr << "Uso: " << argv[0] << " [delta|carga|tabu|memoria] [diretorio_instancias]\n"
+         << "     " << argv[0] << " suite [diretorio_instancias] [saida.json]\n"
+         << "     " << argv[0] << " comparar <base.json> <atual.json> [limiar_%]" << endl;
+    return 1;
+}
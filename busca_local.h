@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "avaliacao.h"
+
+// --- Busca local por flip (usada por GRASP e ILS) ---
+//
+// primeira: primeira melhora guiada por fila. Só volta a examinar um item se o
+//           ganho dele mudou desde a última vez (don't-look bits) ou, para itens
+//           barrados pela capacidade, depois que algum item saiu da mochila.
+// melhor:   melhor melhora; aplica o movimento de maior ganho que cabe até não
+//           haver ganho positivo.
+// O modo é parâmetro de template (BuscaLocal<Modo>); com_busca_local() escolhe
+// a instância em tempo de execução.
+
+enum class ModoBuscaLocal { Primeira, Melhor };
+
+inline bool ler_modo_busca_local(const std::string& nome, ModoBuscaLocal& modo) {
+    if (nome == "primeira") {
+        modo = ModoBuscaLocal::Primeira;
+    } else if (nome == "melhor") {
+        modo = ModoBuscaLocal::Melhor;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Marca de tipo passada ao despachante.
+template <ModoBuscaLocal Modo>
+using TipoBuscaLocal = std::integral_constant<ModoBuscaLocal, Modo>;
+
+// Chama f(TipoBuscaLocal<M>()) com o modo indicado.
+template <class F>
+auto com_busca_local(ModoBuscaLocal modo, F&& f) {
+    if (modo == ModoBuscaLocal::Melhor) return f(TipoBuscaLocal<ModoBuscaLocal::Melhor>());
+    return f(TipoBuscaLocal<ModoBuscaLocal::Primeira>());
+}
+
+// Buffers reaproveitados entre chamadas de FastLocalSearch.
+template <ModoBuscaLocal Modo>
+struct BuscaLocal {
+    static const ModoBuscaLocal modo = Modo;
+    std::vector<int> fila;     // fila circular: cada item aparece no máximo uma vez
+    std::vector<char> na_fila;
+    std::vector<int> barrados;  // ganho positivo, mas não cabiam
+
+    explicit BuscaLocal(int itens) : fila(itens), na_fila(itens, 0) {}
+};
+
+template <class Solucao, ModoBuscaLocal Modo>
+void FastLocalSearch(MotorGanho<Solucao>& motor, BuscaLocal<Modo>& bl) {
+    const int itens = motor.inst.itens;
+    if (itens == 0) return;
+    CONTAR(descidas);
+
+    if constexpr (Modo == ModoBuscaLocal::Melhor) {
+        (void)bl;
+        while (true) {
+            int item = motor.melhor_movimento([](int) { return true; });
+            if (item == -1 || motor.ganho[item] <= 0) break;
+            motor.aplicar(item);
+        }
+        return;
+    }
+
+    int inicio = 0, tamanho = 0;
+    auto enfileirar = [&](int x) {
+        if (bl.na_fila[x]) return;
+        bl.na_fila[x] = 1;
+        bl.fila[(inicio + tamanho) % itens] = x;
+        tamanho++;
+    };
+    for (int i = 0; i < itens; ++i) enfileirar(i);
+    bl.barrados.clear();
+
+    while (tamanho > 0) {
+        int item = bl.fila[inicio];
+        inicio = (inicio + 1) % itens;
+        tamanho--;
+        bl.na_fila[item] = 0;
+        CONTAR(movimentos_avaliados);
+
+        if (motor.ganho[item] <= 0) continue;
+        if (!motor.cabe(item)) {
+            bl.barrados.push_back(item);
+            continue;
+        }
+        bool saindo = motor.sol[item];
+        motor.aplicar(item);
+        for (int x : motor.ultimos_alterados()) enfileirar(x);
+        if (saindo) {
+            for (int x : bl.barrados) enfileirar(x);
+            bl.barrados.clear();
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "kpfs.h"
+#include "simd.h"
+
+// --- Contagem de itens selecionados por conjunto (itemsPorConj) do zero ---
+//
+// O caminho original percorre os conjuntos de cada item selecionado e
+// incrementa os contadores: custo proporcional ao nnz dos selecionados, com
+// escritas espalhadas. Aqui cada conjunto denso guarda uma máscara de bits
+// sobre os itens, no mesmo formato da solução, e o contador é
+// popcount(solução & máscara) palavra a palavra (VPOPCNTQ com AVX-512, POPCNT,
+// ou a versão portátil). Os conjuntos esparsos continuam no caminho original,
+// mas só eles: cada item guarda a lista dos seus conjuntos esparsos.
+//
+// Um conjunto é denso se tem mais de DENSIDADE_MASCARA membros por palavra da
+// solução. Se nenhum é, a instância não ganha nada e usar() devolve false.
+// Mesmo com conjuntos densos, as máscaras só compensam quando a solução tem
+// itens selecionados suficientes: compensa() compara, em incrementos de
+// contador, o trabalho que elas poupam com o que custam (medido: ~3 por vetor
+// de 8 palavras com VPOPCNTQ, ~1 por palavra com POPCNT), e quem chama fica
+// com o caminho original quando não compensa.
+
+const int DENSIDADE_MASCARA = 2;
+const int CUSTO_VETOR_MASCARA = 3;   // incrementos equivalentes, AVX-512
+const int CUSTO_PALAVRA_MASCARA = 1; // incrementos equivalentes, POPCNT/portátil
+
+struct ContagemConjuntos {
+    int palavras = 0;
+    std::vector<int> densos;
+    std::vector<uint64_t> mascaras;                   // mascaras[d * palavras + w], d = posição em 'densos'
+    std::vector<int> esparsos_inicio, esparsos_idx;  // item -> conjuntos esparsos (CSR)
+    double nnz_denso_por_item = 0;
+    long long custo_mascaras = 0;
+
+    ContagemConjuntos() = default;
+
+    explicit ContagemConjuntos(const Instancia& inst) : palavras((inst.itens + 63) / 64) {
+        std::vector<char> denso(inst.quant_conj, 0);
+        for (int j = 0; j < inst.quant_conj; ++j) {
+            if (inst.membros(j).size() > DENSIDADE_MASCARA * palavras) {
+                denso[j] = 1;
+                densos.push_back(j);
+            }
+        }
+        if (densos.empty()) return;
+        mascaras.assign(densos.size() * (size_t)palavras, 0);
+        for (size_t d = 0; d < densos.size(); ++d) {
+            for (int x : inst.membros(densos[d])) mascaras[d * palavras + (x >> 6)] |= uint64_t(1) << (x & 63);
+        }
+        esparsos_inicio.assign(inst.itens + 1, 0);
+        for (int i = 0; i < inst.itens; ++i) {
+            for (int cj : inst.conjuntos(i)) {
+                if (!denso[cj]) esparsos_idx.push_back(cj);
+            }
+            esparsos_inicio[i + 1] = (int)esparsos_idx.size();
+        }
+        nnz_denso_por_item = (double)(inst.nnz - (int)esparsos_idx.size()) / inst.itens;
+        long long por_conjunto = cpu_tem_avx512_popcnt() ? CUSTO_VETOR_MASCARA * ((palavras + 7) / 8) : CUSTO_PALAVRA_MASCARA * palavras;
+        custo_mascaras = por_conjunto * (long long)densos.size();
+    }
+
+    bool usar() const { return !densos.empty(); }
+
+    // Com 'selecionados' itens na solução, contar() sai mais barato que percorrer
+    // os conjuntos de cada selecionado?
+    bool compensa(int selecionados) const { return usar() && selecionados * nnz_denso_por_item > custo_mascaras; }
+
+    // itemsPorConj[j] = número de itens selecionados no conjunto j. Zera e
+    // preenche os primeiros quant_conj contadores.
+    template <class Solucao, class Contador>
+    void contar(const Instancia& inst, const Solucao& sol, std::vector<Contador>& itemsPorConj) const {
+        const uint64_t* s = sol.palavras();
+        std::fill(itemsPorConj.begin(), itemsPorConj.begin() + inst.quant_conj, 0);
+        for (int w = 0; w < palavras; ++w) {
+            for (uint64_t bits = s[w]; bits; bits &= bits - 1) {
+                int i = (w << 6) | __builtin_ctzll(bits);
+                for (int p = esparsos_inicio[i]; p < esparsos_inicio[i + 1]; ++p) itemsPorConj[esparsos_idx[p]]++;
+            }
+        }
+#ifdef KPFS_X86
+        if (cpu_tem_avx512_popcnt()) return contar_densos_avx512(s, itemsPorConj.data());
+        if (cpu_tem_popcnt()) return contar_densos_popcnt(s, itemsPorConj.data());
+#endif
+        for (size_t d = 0; d < densos.size(); ++d) {
+            const uint64_t* m = &mascaras[d * palavras];
+            int total = 0;
+            for (int w = 0; w < palavras; ++w) total += __builtin_popcountll(s[w] & m[w]);
+            itemsPorConj[densos[d]] = (Contador)total;
+        }
+    }
+
+private:
+#ifdef KPFS_X86
+    template <class Contador>
+    __attribute__((target("avx512f,avx512vpopcntdq"))) void contar_densos_avx512(const uint64_t* s, Contador* itemsPorConj) const {
+        const int vetores = (palavras + 7) / 8;
+        const __mmask8 resto = (__mmask8)(0xFF >> (8 * vetores - palavras));
+        for (size_t d = 0; d < densos.size(); ++d) {
+            const uint64_t* m = &mascaras[d * palavras];
+            __m512i soma = _mm512_setzero_si512();
+            for (int v = 0; v < vetores; ++v) {
+                __mmask8 carga = v + 1 < vetores ? (__mmask8)0xFF : resto;
+                __m512i x = _mm512_and_si512(_mm512_maskz_loadu_epi64(carga, s + 8 * v), _mm512_maskz_loadu_epi64(carga, m + 8 * v));
+                soma = _mm512_add_epi64(soma, _mm512_popcnt_epi64(x));
+            }
+            alignas(64) uint64_t parcial[8];
+            _mm512_store_si512(parcial, soma);
+            uint64_t total = 0;
+            for (uint64_t p : parcial) total += p;
+            itemsPorConj[densos[d]] = (Contador)total;
+        }
+    }
+
+    template <class Contador>
+    __attribute__((target("popcnt"))) void contar_densos_popcnt(const uint64_t* s, Contador* itemsPorConj) const {
+        for (size_t d = 0; d < densos.size(); ++d) {
+            const uint64_t* m = &mascaras[d * palavras];
+            int total = 0;
+            for (int w = 0; w < palavras; ++w) total += __builtin_popcountll(s[w] & m[w]);
+            itemsPorConj[densos[d]] = (Contador)total;
+        }
+    }
+#endif
+};
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include <filesystem>
+
+#include "kpfs.h"
+
+using namespace std;
+
+// Converte instâncias texto para o formato binário .kpfsb (ver kpfs.h).
+//
+// Uso: ./conversor <arquivo.txt> [arquivo.kpfsb]
+//      ./conversor <diretorio>          (converte todo kpfs_*.txt ao lado do original)
+
+bool converter(const string& entrada, const string& saida) {
+    Instancia inst;
+    if (!carregar_instancia_texto(entrada, inst)) {
+        cerr << "Erro ao abrir o arquivo: " << entrada << endl;
+        return false;
+    }
+    if (!salvar_instancia_binaria(inst, saida)) {
+        cerr << "Erro ao abrir " << saida << " para escrita.\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        cerr << "Uso: " << argv[0] << " <arquivo_entrada.txt | diretorio> [arquivo_saida.kpfsb]" << endl;
+        return 1;
+    }
+    filesystem::path entrada = argv[1];
+
+    if (!filesystem::is_directory(entrada)) {
+        filesystem::path saida = argc == 3 ? filesystem::path(argv[2]) : filesystem::path(entrada).replace_extension(".kpfsb");
+        return converter(entrada.string(), saida.string()) ? 0 : 1;
+    }
+
+    int convertidos = 0, falhas = 0;
+    for (const auto& arquivo : filesystem::recursive_directory_iterator(entrada)) {
+        const filesystem::path& p = arquivo.path();
+        if (!arquivo.is_regular_file() || p.extension() != ".txt" || p.filename().string().rfind("kpfs_", 0) != 0) continue;
+        if (converter(p.string(), filesystem::path(p).replace_extension(".kpfsb").string())) {
+            convertidos++;
+        } else {
+            falhas++;
+        }
+    }
+    cout << convertidos << " instancias convertidas, " << falhas << " falhas.\n";
+    return falhas == 0 ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "armazem.h"
+
+// --- Diário de trabalhos concluídos (campanha retomável) ---
+//
+// Arquivo texto só de acréscimo. A primeira linha guarda a semente base da
+// campanha e o formato da saída (binario ou texto); depois vêm lotes de
+// trabalhos concluídos, cada um fechado por uma linha de confirmação:
+//
+//   # kpfs-diario 1 <semente_base> <formato>
+//   t <run> <algoritmo> <cenario> <tipo> <tamanho> <arquivo> <semente> <valor> <tempo> <limitante> <contadores|->
+//   ...
+//   c <fim_armazem>
+//
+// Cada lote é gravado com um write e um fsync. Um trabalho só conta como
+// concluído se o lote dele foi confirmado; linhas depois da última confirmação
+// (processo interrompido no meio) são descartadas ao retomar. fim_armazem é o
+// tamanho do armazém (.kpfsr) depois do bloco que contém o lote (0 no formato
+// texto): ao retomar, o armazém é cortado ali, o que desfaz blocos gravados
+// mas não confirmados.
+//
+// O valor, o tempo e o limitante vão no diário para que, no formato texto, o
+// saida_<tamanho>.txt de um grupo possa ser reescrito sem reexecutar os
+// trabalhos que já tinham terminado.
+
+const char* const CABECALHO_DIARIO = "# kpfs-diario 1 ";
+
+struct EstadoDiario {
+    uint64_t semente_base = 0;
+    std::string formato;
+    std::vector<RegistroExecucao> concluidos;  // em ordem de confirmação
+    uint64_t fim_armazem = 0;                  // da última confirmação
+    uint64_t bytes_confirmados = 0;            // até o fim da última confirmação
+};
+
+namespace detalhe_diario {
+
+inline std::string formatar_double(double v) {
+    char buf[32];
+    auto [fim, ec] = std::to_chars(buf, buf + sizeof(buf), v);
+    return std::string(buf, fim);
+}
+
+inline std::string formatar_entrada(const RegistroExecucao& r) {
+    const ChaveExecucao& c = r.chave;
+    std::string contadores = r.contadores;
+    while (!contadores.empty() && contadores.back() == '\n') contadores.pop_back();
+    std::ostringstream out;
+    out << "t " << c.run << " " << c.algoritmo << " " << c.cenario << " " << c.tipo << " " << c.tamanho << " " << c.arquivo
+        << " " << r.semente << " " << r.resultado.valor << " " << formatar_double(r.resultado.tempo) << " "
+        << r.resultado.limitante << " " << (contadores.empty() ? "-" : contadores) << "\n";
+    return out.str();
+}
+
+inline bool ler_entrada(const std::string& linha, RegistroExecucao& r) {
+    std::istringstream in(linha.substr(2));
+    ChaveExecucao& c = r.chave;
+    std::string tempo;
+    if (!(in >> c.run >> c.algoritmo >> c.cenario >> c.tipo >> c.tamanho >> c.arquivo >> r.semente >> r.resultado.valor >>
+          tempo >> r.resultado.limitante)) {
+        return false;
+    }
+    auto [fim, ec] = std::from_chars(tempo.data(), tempo.data() + tempo.size(), r.resultado.tempo);
+    if (ec != std::errc()) return false;
+    std::string resto;
+    std::getline(in >> std::ws, resto);
+    r.contadores = resto == "-" || resto.empty() ? "" : resto + "\n";
+    return true;
+}
+
+}  // namespace detalhe_diario
+
+// Lê o diário: semente base e trabalhos confirmados. false se não existir ou
+// não tiver cabeçalho.
+inline bool ler_diario(const std::string& caminho, EstadoDiario& estado) {
+    std::ifstream arquivo(caminho, std::ios::binary);
+    std::string linha;
+    if (!std::getline(arquivo, linha) || linha.rfind(CABECALHO_DIARIO, 0) != 0) return false;
+    estado = EstadoDiario();
+    std::istringstream cabecalho(linha.substr(std::strlen(CABECALHO_DIARIO)));
+    if (!(cabecalho >> estado.semente_base >> estado.formato)) return false;
+    uint64_t lidos = linha.size() + 1;
+    estado.bytes_confirmados = lidos;
+
+    std::vector<RegistroExecucao> lote;
+    while (std::getline(arquivo, linha)) {
+        if (arquivo.eof()) break;  // última linha sem '\n': escrita interrompida
+        lidos += linha.size() + 1;
+        RegistroExecucao r;
+        if (linha.rfind("t ", 0) == 0 && detalhe_diario::ler_entrada(linha, r)) {
+            lote.push_back(std::move(r));
+        } else if (linha.rfind("c ", 0) == 0) {
+            estado.fim_armazem = std::strtoull(linha.c_str() + 2, nullptr, 10);
+            estado.bytes_confirmados = lidos;
+            for (RegistroExecucao& c : lote) estado.concluidos.push_back(std::move(c));
+            lote.clear();
+        } else {
+            break;  // linha corrompida: nada depois dela é confiável
+        }
+    }
+    return true;
+}
+
+class DiarioCampanha {
+public:
+    ~DiarioCampanha() { fechar(); }
+
+    // Começa um diário novo (apaga o anterior).
+    bool criar(const std::string& caminho, uint64_t semente_base, const std::string& formato) {
+        fechar();
+        fd_ = ::open(caminho.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (fd_ < 0) return false;
+        std::string cabecalho = CABECALHO_DIARIO + std::to_string(semente_base) + " " + formato + "\n";
+        return detalhe_armazem::escrever_tudo(fd_, cabecalho) && ::fsync(fd_) == 0;
+    }
+
+    // Continua um diário lido por ler_diario(), cortando o que veio depois da
+    // última confirmação.
+    bool continuar(const std::string& caminho, const EstadoDiario& estado) {
+        fechar();
+        if (::truncate(caminho.c_str(), (off_t)estado.bytes_confirmados) != 0) return false;
+        fd_ = ::open(caminho.c_str(), O_WRONLY | O_APPEND);
+        return fd_ >= 0 && ::fsync(fd_) == 0;
+    }
+
+    // Confirma um lote de trabalhos concluídos (dados já duráveis). Pode ser
+    // chamado de várias threads.
+    bool confirmar(const std::vector<RegistroExecucao>& lote, uint64_t fim_armazem) {
+        std::string texto;
+        for (const RegistroExecucao& r : lote) texto += detalhe_diario::formatar_entrada(r);
+        texto += "c " + std::to_string(fim_armazem) + "\n";
+        std::lock_guard<std::mutex> lock(trava_);
+        return fd_ >= 0 && detalhe_armazem::escrever_tudo(fd_, texto) && ::fsync(fd_) == 0;
+    }
+
+    void fechar() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    std::mutex trava_;
+    int fd_ = -1;
+};
+
+// Grava um arquivo e só devolve depois que ele está no disco.
+inline bool escrever_duravel(const std::string& caminho, const std::string& conteudo) {
+    int fd = ::open(caminho.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = detalhe_armazem::escrever_tudo(fd, conteudo) && ::fsync(fd) == 0;
+    return ::close(fd) == 0 && ok;
+}
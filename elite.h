@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <vector>
+
+#include "avaliacao.h"
+#include "busca_local.h"
+#include "instrumentacao.h"
+#include "solucao.h"
+
+// --- Conjunto elite e path relinking (GRASP e ILS) ---
+//
+// PoolElite guarda até TAMANHO_ELITE soluções boas e diferentes entre si
+// (distância de Hamming entre os vetores de bits). Uma solução nova entra se:
+//   - o pool não está cheio e ela não repete nenhuma solução guardada; ou
+//   - é melhor que a pior guardada e fica a pelo menos DISTANCIA_MIN_ELITE de
+//     todas (ou é melhor que todas). Sai a mais parecida com ela entre as
+//     piores que ela.
+//
+// PathRelinking caminha do estado atual do motor até uma solução guia: a cada
+// passo inverte, entre os itens em que as duas ainda diferem, o de maior
+// ganho que cabe (o ganho já está no motor, sem reavaliar). O melhor ponto
+// intermediário (sem contar as pontas) recebe busca local. O motor termina
+// nessa solução.
+
+const int TAMANHO_ELITE = 10;
+const int DISTANCIA_MIN_ELITE = 4;  // bits
+const int DISTANCIA_MIN_RELINK = 4;  // abaixo disso não há caminho que valha
+
+template <class Solucao>
+struct PoolElite {
+    struct Entrada {
+        Solucao sol;
+        int valor;
+    };
+    std::vector<Entrada> entradas;
+
+    int tamanho() const { return (int)entradas.size(); }
+
+    // Devolve se a solução entrou.
+    bool inserir(const Solucao& sol, int valor) {
+        int pior = -1, mais_parecida = -1, dist_parecida = INT_MAX, dist_min = INT_MAX;
+        bool melhor_de_todas = true;
+        for (int k = 0; k < tamanho(); ++k) {
+            const Entrada& e = entradas[k];
+            int d = distancia_hamming(sol, e.sol);
+            if (d == 0) return false;
+            dist_min = std::min(dist_min, d);
+            if (e.valor >= valor) melhor_de_todas = false;
+            if (pior < 0 || e.valor < entradas[pior].valor) pior = k;
+            if (e.valor <= valor && d < dist_parecida) {
+                dist_parecida = d;
+                mais_parecida = k;
+            }
+        }
+        if (tamanho() < TAMANHO_ELITE) {
+            entradas.push_back({sol, valor});
+            return true;
+        }
+        if (valor <= entradas[pior].valor) return false;
+        if (!melhor_de_todas && dist_min < DISTANCIA_MIN_ELITE) return false;
+        entradas[mais_parecida] = {sol, valor};
+        return true;
+    }
+
+    template <class Rng>
+    const Solucao& sortear(Rng& rng) const {
+        return entradas[std::uniform_int_distribution<int>(0, tamanho() - 1)(rng)].sol;
+    }
+};
+
+// Buffers reaproveitados entre religamentos.
+template <class Solucao>
+struct PathRelinking {
+    std::vector<int> diferenca;
+    Solucao melhor;
+
+    // Religa o motor com 'guia' e devolve o valor final (motor.valor).
+    template <class Busca>
+    int operator()(MotorGanho<Solucao>& motor, const Solucao& guia, Busca& bl) {
+        diferenca.clear();
+        for (int k = 0; k < guia.num_palavras(); ++k) {
+            for (uint64_t bits = motor.sol.palavras()[k] ^ guia.palavras()[k]; bits; bits &= bits - 1) {
+                diferenca.push_back((k << 6) | __builtin_ctzll(bits));
+            }
+        }
+        if ((int)diferenca.size() < DISTANCIA_MIN_RELINK) return motor.valor;
+        CONTAR(religamentos);
+
+        int melhor_valor = INT_MIN;
+        while (diferenca.size() > 1) {
+            int escolhido = -1;
+            for (int p = 0; p < (int)diferenca.size(); ++p) {
+                int item = diferenca[p];
+                CONTAR(movimentos_avaliados);
+                if (!motor.cabe(item)) continue;
+                if (escolhido < 0 || motor.ganho[item] > motor.ganho[diferenca[escolhido]]) escolhido = p;
+            }
+            if (escolhido < 0) break;
+            motor.aplicar(diferenca[escolhido]);
+            diferenca[escolhido] = diferenca.back();
+            diferenca.pop_back();
+            if (motor.valor > melhor_valor) {
+                melhor_valor = motor.valor;
+                melhor = motor.sol;
+            }
+        }
+        if (melhor_valor == INT_MIN) return motor.valor;
+        motor.mover_para(melhor);
+        FastLocalSearch(motor, bl);
+        return motor.valor;
+    }
+};
@@ -0,0 +1,78 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "armazem.h"
+
+using namespace std;
+
+// Exporta um armazém de campanha (armazem.h) para o layout em texto do
+// leitura_exec: resultados/run_R/<algoritmo>/<tipo>/saida_<tamanho>.txt (uma
+// linha por instância, na ordem cenário/arquivo), os contadores ao lado e
+// convergencia/run_R/<algoritmo>/<tipo>/conv_s*_t*_z*_f*.txt.
+//
+// Uso: ./exportar [armazem.kpfsr] [diretorio_destino]
+//      (padrão: resultados/campanha.kpfsr e o diretório atual)
+
+int main(int argc, char* argv[]) {
+    if (argc > 3) {
+        cerr << "Uso: " << argv[0] << " [armazem.kpfsr] [diretorio_destino]" << endl;
+        return 1;
+    }
+    string armazem = argc >= 2 ? argv[1] : "resultados/campanha.kpfsr";
+    string destino = argc >= 3 ? argv[2] : ".";
+
+    LeitorArmazem leitor;
+    if (!leitor.abrir(armazem)) {
+        cerr << "Erro ao abrir o armazém: " << armazem << endl;
+        return 1;
+    }
+    vector<RegistroExecucao> registros = leitor.ler_todos();
+
+    // Ordem dos arquivos; uma chave repetida fica com o último registro.
+    stable_sort(registros.begin(), registros.end(),
+                [](const RegistroExecucao& a, const RegistroExecucao& b) { return a.chave < b.chave; });
+    vector<const RegistroExecucao*> unicos;
+    for (size_t k = 0; k < registros.size(); ++k) {
+        if (k + 1 < registros.size() && registros[k + 1].chave == registros[k].chave) continue;
+        unicos.push_back(&registros[k]);
+    }
+
+    set<string> diretorios;
+    size_t arquivos = 0;
+    bool erro = false;
+    for (size_t k = 0; k < unicos.size();) {
+        const ChaveExecucao& grupo = unicos[k]->chave;
+        string saida = caminho_saida(destino, grupo);
+        for (const string& d : {diretorio_saida(destino, grupo), diretorio_convergencia(destino, grupo)}) {
+            if (diretorios.insert(d).second) filesystem::create_directories(d);
+        }
+
+        string conteudo, contadores;
+        for (; k < unicos.size() && caminho_saida(destino, unicos[k]->chave) == saida; ++k) {
+            const RegistroExecucao& r = *unicos[k];
+            conteudo += formatar_saida(r.resultado);
+            contadores += r.contadores;
+            erro |= !escrever_convergencia(caminho_convergencia(destino, r.chave), r.resultado);
+            arquivos++;
+        }
+        ofstream arquivo(saida);
+        arquivo << conteudo;
+        erro |= !arquivo;
+        arquivos++;
+        if (!contadores.empty()) {
+            ofstream arquivo_contadores(caminho_contadores(saida));
+            arquivo_contadores << contadores;
+            erro |= !arquivo_contadores;
+            arquivos++;
+        }
+    }
+
+    cout << unicos.size() << " execuções (" << leitor.blocos() << " blocos) exportadas em " << arquivos
+         << " arquivos." << endl;
+    if (erro) cerr << "Erro ao escrever parte dos arquivos." << endl;
+    return erro ? 1 : 0;
+}
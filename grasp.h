@@ -0,0 +1,214 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+#include "kpfs.h"
+#include "orcamento.h"
+#include "resultado.h"
+#include "solucao.h"
+#include "avaliacao.h"
+#include "busca_local.h"
+#include "elite.h"
+
+using namespace std;
+
+// --- Parâmetros da Meta-heurística ---
+const int GRASP_MAX_SEM_MELHORA = 300;
+
+// Itens em ordem decrescente de lucro/peso.
+inline vector<pair<double, int>> CandidatosGRASP(const Instancia& inst) {
+    vector<pair<double, int>> candidates(inst.itens);
+    for (int i = 0; i < inst.itens; i++) {
+        candidates[i] = { (inst.peso[i] == 0 ? 1e12 + inst.lucro[i] : (double)inst.lucro[i] / inst.peso[i]), i };
+    }
+    sort(candidates.rbegin(), candidates.rend());
+    return candidates;
+}
+
+// Construção gulosa aleatorizada: cada candidato é tentado com probabilidade
+// decrescente ao longo da lista. O motor chega à solução construída com
+// mover_para(), que só inverte os itens que diferem da solução anterior quando
+// são poucos.
+template <class Solucao>
+Solucao ConstruirGRASP(const Instancia& inst, const vector<pair<double, int>>& candidates, mt19937_64& rng) {
+    uniform_real_distribution<double> prob_dist(0.0, 1.0);
+    Solucao currentSolution(inst.itens);
+    int somaPeso = 0;
+    double prob_alpha = 0.85; 
+    for (auto const& [ratio, currItem] : candidates) {
+        if (prob_dist(rng) < prob_alpha) {
+            if (somaPeso + inst.peso[currItem] <= inst.capacidade) {
+                currentSolution.set(currItem);
+                somaPeso += inst.peso[currItem];
+            }
+        }
+        prob_alpha *= 0.97;
+    }
+    return currentSolution;
+}
+
+// Depois da busca local: religa o ótimo local com uma solução da elite (se
+// houver) e guarda os dois na elite. Devolve o melhor dos dois valores.
+template <class Solucao, class Busca>
+int ReligarComElite(MotorGanho<Solucao>& motor, Busca& busca_local, PoolElite<Solucao>& elite,
+                    PathRelinking<Solucao>& relinking, Solucao& otimo_local, mt19937_64& rng) {
+    int valor = motor.valor;
+    if (elite.tamanho() > 0) {
+        FASE(tempo_busca_local);
+        otimo_local = motor.sol;
+        int valor_local = motor.valor;
+        valor = max(valor, relinking(motor, elite.sortear(rng), busca_local));
+        elite.inserir(otimo_local, valor_local);
+    }
+    elite.inserir(motor.sol, motor.valor);
+    return valor;
+}
+
+template <class Solucao, ModoBuscaLocal ModoBusca>
+Resultado GRASP(const Instancia& inst, mt19937_64& rng, double tempoLimite, int limitante = INT_MAX) {
+    contadores_thread() = Contadores();
+    vector<pair<double, int>> candidates = CandidatosGRASP(inst);
+
+    int bestValue = -2e9;
+    
+    MotorGanho<Solucao> motor(inst);
+    BuscaLocal<ModoBusca> busca_local(inst.itens);
+    PoolElite<Solucao> elite;
+    PathRelinking<Solucao> relinking;
+    Solucao otimo_local(inst.itens);
+ 
+    vector<pair<double, int>> convergence_data;
+
+    Orcamento orcamento(tempoLimite, GRASP_MAX_SEM_MELHORA);
+    orcamento.limitante = limitante;
+
+    while (orcamento.continuar()) {
+
+        INSTRUMENTAR(CronometroFase construcao(contadores_thread().tempo_construcao);)
+        Solucao currentSolution = ConstruirGRASP<Solucao>(inst, candidates, rng);
+        motor.mover_para(currentSolution);
+        INSTRUMENTAR(construcao.parar();)
+        {
+            FASE(tempo_busca_local);
+            FastLocalSearch(motor, busca_local);
+        }
+        int currentValue = ReligarComElite(motor, busca_local, elite, relinking, otimo_local, rng);
+        
+        if (currentValue > bestValue) {
+            bestValue = currentValue;
+            orcamento.melhorou(bestValue);
+            convergence_data.push_back({orcamento.decorrido(), bestValue});
+        } else {
+            orcamento.nao_melhorou();
+        }
+    }
+
+    if (convergence_data.empty() || convergence_data.back().second < bestValue) {
+        convergence_data.push_back({tempoLimite, bestValue});
+    }
+
+    Resultado resultado;
+    resultado.valor = bestValue;
+    resultado.convergencia = move(convergence_data);
+    resultado.contadores = coletar_contadores(orcamento.decorrido());
+    return resultado;
+}
+
+// --- GRASP paralelo ---
+//
+// 'threads' workers fazem iterações independentes, cada um com seu gerador
+// (semeado a partir de 'rng'), seu MotorGanho (com o próprio itemsPorConj) e
+// sua elite.
+// Compartilham só dois atômicos: o melhor valor (atualizado por
+// compare-and-swap) e o contador global de iterações sem melhora, com o mesmo
+// critério de parada do GRASP sequencial; param também quando o melhor valor
+// atinge o limitante. A solução incumbente não é compartilhada: Resultado só
+// leva o valor (o GRASP sequencial também não guarda a solução), e nenhum
+// worker parte da solução dos outros. Os pontos de convergência de cada
+// worker (só quando ele melhorou o valor global) são intercalados por tempo no
+// final.
+template <class Solucao, ModoBuscaLocal ModoBusca>
+Resultado GRASP_Paralelo(const Instancia& inst, mt19937_64& rng, double tempoLimite, int threads, int limitante = INT_MAX) {
+    if (threads <= 1) return GRASP<Solucao, ModoBusca>(inst, rng, tempoLimite, limitante);
+
+    const vector<pair<double, int>> candidates = CandidatosGRASP(inst);
+
+    atomic<int> bestValue(-2e9);
+    atomic<int> iterationsWithoutImproving(0);
+    vector<vector<pair<double, int>>> convergencia_worker(threads);
+    vector<Contadores> contadores_worker(threads);
+    vector<uint64_t> sementes(threads);
+    for (uint64_t& s : sementes) s = rng();
+
+    auto start_time = Orcamento::relogio::now();
+
+    auto worker = [&](int w) {
+        contadores_thread() = Contadores();
+        mt19937_64 rng_worker(sementes[w]);
+        MotorGanho<Solucao> motor(inst);
+        BuscaLocal<ModoBusca> busca_local(inst.itens);
+        PoolElite<Solucao> elite;
+        PathRelinking<Solucao> relinking;
+        Solucao otimo_local(inst.itens);
+        vector<pair<double, int>>& convergence_data = convergencia_worker[w];
+        Orcamento orcamento(tempoLimite, -1, -1, start_time);  // a estagnação é global
+
+        while (orcamento.continuar() && iterationsWithoutImproving.load(memory_order_relaxed) <= GRASP_MAX_SEM_MELHORA &&
+               bestValue.load(memory_order_relaxed) < limitante) {
+
+            INSTRUMENTAR(CronometroFase construcao(contadores_thread().tempo_construcao);)
+            Solucao currentSolution = ConstruirGRASP<Solucao>(inst, candidates, rng_worker);
+            motor.mover_para(currentSolution);
+            INSTRUMENTAR(construcao.parar();)
+            {
+                FASE(tempo_busca_local);
+                FastLocalSearch(motor, busca_local);
+            }
+            int currentValue = ReligarComElite(motor, busca_local, elite, relinking, otimo_local, rng_worker);
+
+            int atual = bestValue.load(memory_order_relaxed);
+            bool melhorou = false;
+            while (currentValue > atual) {
+                if (bestValue.compare_exchange_weak(atual, currentValue, memory_order_relaxed)) {
+                    melhorou = true;
+                    break;
+                }
+            }
+            if (melhorou) {
+                iterationsWithoutImproving.store(0, memory_order_relaxed);
+                convergence_data.push_back({orcamento.decorrido(), currentValue});
+            } else {
+                iterationsWithoutImproving.fetch_add(1, memory_order_relaxed);
+            }
+        }
+        contadores_worker[w] = coletar_contadores(orcamento.decorrido());
+    };
+
+    vector<thread> pool;
+    for (int w = 0; w < threads; ++w) pool.emplace_back(worker, w);
+    for (thread& t : pool) t.join();
+
+    vector<pair<double, int>> convergence_data = intercalar_convergencia(convergencia_worker);
+
+    int melhor = bestValue.load();
+    if (convergence_data.empty() || convergence_data.back().second < melhor) {
+        convergence_data.push_back({tempoLimite, melhor});
+    }
+
+    Resultado resultado;
+    resultado.valor = melhor;
+    resultado.convergencia = move(convergence_data);
+    for (const Contadores& c : contadores_worker) resultado.contadores += c;
+    return resultado;
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+
+#include "kpfs.h"
+#include "orcamento.h"
+#include "resultado.h"
+#include "solucao.h"
+#include "avaliacao.h"
+#include "busca_local.h"
+#include "elite.h"
+
+using namespace std;
+
+// --- Parâmetros da Meta-heurística ---
+const int PERTURBATION_STRENGTH = 4;
+const int ILS_MAX_SEM_MELHORA = 300;
+const int ILS_INTERVALO_RELINK = 25;  // iterações sem melhora entre religamentos com a elite
+// Modelo de ilhas
+const int INTERVALO_MIGRACAO = 20;   // iterações entre envios da elite
+const int PASSO_FORCA_ILHA = 2;      // ilha w perturba com PERTURBATION_STRENGTH + w * PASSO_FORCA_ILHA
+
+// Função de Perturbação: sorteia 'strength' flips e, se o resultado respeita a
+// capacidade, leva o motor até ele com mover_para() (flips incrementais, ou
+// carregar() quando os flips custariam mais). Perturbações inviáveis seriam
+// descartadas de qualquer forma, então nem chegam ao motor. Devolve se aplicou.
+template <class Solucao>
+bool Perturb(const Instancia& inst, mt19937_64& rng, MotorGanho<Solucao>& motor, int strength, vector<int>& flips) {
+    uniform_int_distribution<int> item_dist(0, inst.itens - 1);
+    CONTAR(perturbacoes);
+    flips.clear();
+    int peso = motor.somaPeso;
+    for (int i = 0; i < strength; ++i) {
+        int item = item_dist(rng);
+        bool dentro = motor.sol[item] != (count(flips.begin(), flips.end(), item) % 2 == 1);
+        peso += dentro ? -inst.peso[item] : inst.peso[item];
+        flips.push_back(item);
+    }
+    if (peso > inst.capacidade) return false;
+    Solucao alvo = motor.sol;
+    for (int item : flips) alvo.flip(item);
+    motor.mover_para(alvo);
+    return true;
+}
+ 
+// Religa a solução corrente (no motor) com uma solução da elite. Se o
+// resultado for melhor, vira a corrente e entra na elite; senão o motor volta
+// à corrente. Devolve o valor corrente.
+template <class Solucao, class Busca>
+int ReligarCorrente(MotorGanho<Solucao>& motor, Busca& busca_local, PoolElite<Solucao>& elite,
+                    PathRelinking<Solucao>& relinking, int current_value, mt19937_64& rng) {
+    if (elite.tamanho() < 2) return current_value;
+    FASE(tempo_busca_local);
+    motor.iniciar_registro();
+    int valor = relinking(motor, elite.sortear(rng), busca_local);
+    if (valor > current_value) {
+        motor.confirmar();
+        elite.inserir(motor.sol, valor);
+        return valor;
+    }
+    motor.desfazer();
+    return current_value;
+}
+
+// Solução inicial gulosa (lucro/peso) com sorteio de rápido decaimento.
+template <class Solucao>
+Solucao SolucaoInicialILS(const Instancia& inst, mt19937_64& rng) {
+    Solucao current_solution(inst.itens);
+    int current_peso = 0;
+    
+    uniform_real_distribution<double> prob_dist(0.0, 1.0);
+    vector<pair<double, int>> candidates(inst.itens);
+    for (int i = 0; i < inst.itens; i++) {
+        candidates[i] = { (inst.peso[i] == 0 ? 1e12 + inst.lucro[i] : (double)inst.lucro[i] / inst.peso[i]), i };
+    }
+    sort(candidates.rbegin(), candidates.rend());
+
+    double prob_alpha = 0.85; 
+    for (auto const& [ratio, currItem] : candidates) {
+        if (prob_dist(rng) < prob_alpha) {
+            if (current_peso + inst.peso[currItem] <= inst.capacidade) {
+                current_solution.set(currItem);
+                current_peso += inst.peso[currItem];
+            }
+        }
+        prob_alpha *= 0.5;
+    }
+    return current_solution;
+}
+
+template <class Solucao, ModoBuscaLocal ModoBusca>
+Resultado ILS(const Instancia& inst, mt19937_64& rng, double tempoLimite, int limitante = INT_MAX) {
+    contadores_thread() = Contadores();
+    auto inicio = chrono::high_resolution_clock::now();
+
+    // 1. GERAÇÃO DA SOLUÇÃO INICIAL (Gulosa)
+    INSTRUMENTAR(CronometroFase construcao(contadores_thread().tempo_construcao);)
+    Solucao current_solution = SolucaoInicialILS<Solucao>(inst, rng);
+    
+    MotorGanho<Solucao> motor(inst);
+    BuscaLocal<ModoBusca> busca_local(inst.itens);
+    Orcamento orcamento(tempoLimite, ILS_MAX_SEM_MELHORA);
+    orcamento.limitante = limitante;
+    
+    // 2. BUSCA LOCAL INICIAL
+    motor.carregar(current_solution);
+    INSTRUMENTAR(construcao.parar();)
+    {
+        FASE(tempo_busca_local);
+        FastLocalSearch(motor, busca_local);
+    }
+    int current_value = motor.valor;
+    
+    int best_value_so_far = current_value;
+ 
+    vector<pair<double, int>> convergence_data; 
+    convergence_data.push_back({orcamento.decorrido(), best_value_so_far});
+
+    vector<int> flips;
+    PoolElite<Solucao> elite;
+    PathRelinking<Solucao> relinking;
+    elite.inserir(motor.sol, current_value);
+
+    // 3. LOOP PRINCIPAL DO ILS
+    // O motor sempre volta à solução corrente: a perturbação e a busca local
+    // são flips registrados, desfeitos se o resultado não for melhor. Cada
+    // solução corrente nova entra na elite; após ILS_INTERVALO_RELINK
+    // iterações sem melhora, a corrente é religada com uma solução da elite.
+    while (orcamento.continuar()) {
+
+        INSTRUMENTAR(CronometroFase perturbacao(contadores_thread().tempo_construcao);)
+        motor.iniciar_registro();
+        bool viavel = Perturb(inst, rng, motor, PERTURBATION_STRENGTH, flips);
+        INSTRUMENTAR(perturbacao.parar();)
+        int perturbed_value = -2e9;
+        if (viavel) {
+            FASE(tempo_busca_local);
+            FastLocalSearch(motor, busca_local);
+            perturbed_value = motor.valor;
+        }
+        
+        if (perturbed_value > current_value) {
+            motor.confirmar();
+            current_value = perturbed_value;
+            elite.inserir(motor.sol, current_value);
+        } else {
+            if (viavel) elite.inserir(motor.sol, perturbed_value);
+            FASE(tempo_construcao);
+            motor.desfazer();
+        }
+        if (orcamento.sem_melhora > 0 && orcamento.sem_melhora % ILS_INTERVALO_RELINK == 0) {
+            current_value = ReligarCorrente(motor, busca_local, elite, relinking, current_value, rng);
+        }
+        
+        if (current_value > best_value_so_far) {
+            best_value_so_far = current_value;
+            orcamento.melhorou(best_value_so_far);
+            // MUDANÇA: Registra o ponto de melhoria
+            convergence_data.push_back({orcamento.decorrido(), best_value_so_far});
+        } else {
+            orcamento.nao_melhorou();
+        }
+    }
+
+    if (convergence_data.empty() || convergence_data.back().second < best_value_so_far) {
+        convergence_data.push_back({tempoLimite, best_value_so_far});
+    } else {
+        convergence_data.push_back({tempoLimite, convergence_data.back().second});
+    }
+
+    Resultado resultado;
+    resultado.valor = best_value_so_far;
+    resultado.convergencia = move(convergence_data);
+    resultado.contadores = coletar_contadores(chrono::duration<double>(chrono::high_resolution_clock::now() - inicio).count());
+    return resultado;
+}
+
+// --- ILS em ilhas ---
+//
+// Cada thread é uma ilha com seu ILS, seu gerador e sua força de perturbação
+// (PERTURBATION_STRENGTH + w * PASSO_FORCA_ILHA). As ilhas formam um anel: a
+// cada INTERVALO_MIGRACAO iterações, a ilha w põe sua melhor solução na caixa
+// da ilha w + 1 e olha a própria caixa. A caixa é um slot único sem trava
+// (um produtor, um consumidor, sinalizado por um atômico); se ainda está cheia
+// o envio é descartado. O migrante leva valor e peso junto com os bits, e é
+// aceito como solução corrente se for melhor: o motor vai até ele com
+// mover_para(). Todas as ilhas param quando o melhor valor global atinge o
+// limitante.
+
+template <class Solucao>
+struct Migrante {
+    Solucao sol;
+    int valor = 0;
+    int peso = 0;
+};
+
+template <class Solucao>
+struct CaixaMigracao {
+    Migrante<Solucao> migrante;
+    atomic<bool> cheia{false};
+
+    explicit CaixaMigracao(int itens) { migrante.sol = Solucao(itens); }
+
+    // Chamado só pela ilha anterior no anel.
+    bool enviar(const Solucao& sol, int valor, int peso) {
+        if (cheia.load(memory_order_acquire)) return false;
+        migrante.sol = sol;
+        migrante.valor = valor;
+        migrante.peso = peso;
+        cheia.store(true, memory_order_release);
+        return true;
+    }
+
+    // Chamado só pela dona da caixa.
+    bool receber(Migrante<Solucao>& destino) {
+        if (!cheia.load(memory_order_acquire)) return false;
+        destino = migrante;
+        cheia.store(false, memory_order_release);
+        return true;
+    }
+};
+
+template <class Solucao, ModoBuscaLocal ModoBusca>
+Resultado ILS_Ilhas(const Instancia& inst, mt19937_64& rng, double tempoLimite, int ilhas, int limitante = INT_MAX) {
+    if (ilhas <= 1) return ILS<Solucao, ModoBusca>(inst, rng, tempoLimite, limitante);
+
+    vector<unique_ptr<CaixaMigracao<Solucao>>> caixas;
+    vector<uint64_t> sementes(ilhas);
+    for (int w = 0; w < ilhas; ++w) {
+        caixas.push_back(make_unique<CaixaMigracao<Solucao>>(inst.itens));
+        sementes[w] = rng();
+    }
+
+    atomic<int> bestValue(-2e9);
+    vector<vector<pair<double, int>>> convergencia_ilha(ilhas);
+    vector<Contadores> contadores_ilha(ilhas);
+    auto start_time = Orcamento::relogio::now();
+
+    auto ilha = [&](int w) {
+        contadores_thread() = Contadores();
+        mt19937_64 rng_ilha(sementes[w]);
+        const int forca = PERTURBATION_STRENGTH + w * PASSO_FORCA_ILHA;
+        MotorGanho<Solucao> motor(inst);
+        BuscaLocal<ModoBusca> busca_local(inst.itens);
+
+        INSTRUMENTAR(CronometroFase construcao(contadores_thread().tempo_construcao);)
+        motor.carregar(SolucaoInicialILS<Solucao>(inst, rng_ilha));
+        INSTRUMENTAR(construcao.parar();)
+        {
+            FASE(tempo_busca_local);
+            FastLocalSearch(motor, busca_local);
+        }
+        int current_value = motor.valor;
+
+        Solucao best_solution = motor.sol;
+        int best_value = current_value, best_peso = motor.somaPeso;
+        auto registrar = [&](double elapsed_time) {
+            int atual = bestValue.load(memory_order_relaxed);
+            while (best_value > atual) {
+                if (bestValue.compare_exchange_weak(atual, best_value, memory_order_relaxed)) {
+                    convergencia_ilha[w].push_back({elapsed_time, best_value});
+                    return;
+                }
+            }
+        };
+        Orcamento orcamento(tempoLimite, ILS_MAX_SEM_MELHORA, -1, start_time);
+        registrar(orcamento.decorrido());
+
+        Migrante<Solucao> chegada;
+        chegada.sol = Solucao(inst.itens);
+        vector<int> flips;
+        PoolElite<Solucao> elite;
+        PathRelinking<Solucao> relinking;
+        elite.inserir(motor.sol, current_value);
+
+        while (orcamento.continuar() && bestValue.load(memory_order_relaxed) < limitante) {
+
+            INSTRUMENTAR(CronometroFase perturbacao(contadores_thread().tempo_construcao);)
+            motor.iniciar_registro();
+            bool viavel = Perturb(inst, rng_ilha, motor, forca, flips);
+            INSTRUMENTAR(perturbacao.parar();)
+            int perturbed_value = -2e9;
+            if (viavel) {
+                FASE(tempo_busca_local);
+                FastLocalSearch(motor, busca_local);
+                perturbed_value = motor.valor;
+            }
+            if (perturbed_value > current_value) {
+                motor.confirmar();
+                current_value = perturbed_value;
+                elite.inserir(motor.sol, current_value);
+            } else {
+                if (viavel) elite.inserir(motor.sol, perturbed_value);
+                FASE(tempo_construcao);
+                motor.desfazer();
+            }
+            if (orcamento.sem_melhora > 0 && orcamento.sem_melhora % ILS_INTERVALO_RELINK == 0) {
+                current_value = ReligarCorrente(motor, busca_local, elite, relinking, current_value, rng_ilha);
+            }
+
+            if (orcamento.iteracoes % INTERVALO_MIGRACAO == 0) {
+                caixas[(w + 1) % ilhas]->enviar(best_solution, best_value, best_peso);
+                if (caixas[w]->receber(chegada) && chegada.valor > current_value) {
+                    motor.mover_para(chegada.sol);
+                    current_value = chegada.valor;
+                    elite.inserir(motor.sol, current_value);
+                }
+            }
+
+            if (current_value > best_value) {
+                best_solution = motor.sol;
+                best_value = current_value;
+                best_peso = motor.somaPeso;
+                orcamento.melhorou();
+                registrar(orcamento.decorrido());
+            } else {
+                orcamento.nao_melhorou();
+            }
+        }
+        contadores_ilha[w] = coletar_contadores(orcamento.decorrido());
+    };
+
+    vector<thread> pool;
+    for (int w = 0; w < ilhas; ++w) pool.emplace_back(ilha, w);
+    for (thread& t : pool) t.join();
+
+    vector<pair<double, int>> convergence_data = intercalar_convergencia(convergencia_ilha);
+    int melhor = bestValue.load();
+    convergence_data.push_back({tempoLimite, melhor});
+
+    Resultado resultado;
+    resultado.valor = melhor;
+    resultado.convergencia = move(convergence_data);
+    for (const Contadores& c : contadores_ilha) resultado.contadores += c;
+    return resultado;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+// --- Contadores de instrumentação ---
+//
+// Só existem com -DKPFS_INSTRUMENTACAO. Sem a flag as macros abaixo não geram
+// código e os contadores do Resultado ficam zerados.
+//
+// Cada thread tem os seus (contadores_thread()); o algoritmo zera no início,
+// copia para o Resultado no fim e, nas versões paralelas, soma os das threads
+// (inclusive os tempos, que passam a ser tempo de CPU somado).
+//   movimentos_avaliados  flips examinados (MotorGanho, fila da busca local, SA)
+//   movimentos_aceitos    flips aplicados
+//   tabu_bloqueios        movimentos recusados pela memória tabu
+//   aspiracoes            movimentos tabu aceitos por superar o melhor valor
+//   descidas              chamadas de FastLocalSearch
+//   perturbacoes          chamadas de Perturb (ILS)
+//   religamentos          path relinkings com a elite (GRASP e ILS)
+//   reavaliacoes          avaliações completas de uma solução, O(nnz)
+//   tempo_*               segundos em cada fase. Construção inclui a perturbação
+//                         do ILS; no SA o laço inteiro conta como busca local
+//                         (cronometrar cada proposta custaria mais que ela).
+//                         Controle é o que sobra do tempo total (relógio,
+//                         convergência, memória tabu, trocas, migração)
+
+struct Contadores {
+    long long movimentos_avaliados = 0;
+    long long movimentos_aceitos = 0;
+    long long tabu_bloqueios = 0;
+    long long aspiracoes = 0;
+    long long descidas = 0;
+    long long perturbacoes = 0;
+    long long religamentos = 0;
+    long long reavaliacoes = 0;
+    double tempo_construcao = 0;
+    double tempo_busca_local = 0;
+    double tempo_controle = 0;
+
+    Contadores& operator+=(const Contadores& o) {
+        movimentos_avaliados += o.movimentos_avaliados;
+        movimentos_aceitos += o.movimentos_aceitos;
+        tabu_bloqueios += o.tabu_bloqueios;
+        aspiracoes += o.aspiracoes;
+        descidas += o.descidas;
+        perturbacoes += o.perturbacoes;
+        religamentos += o.religamentos;
+        reavaliacoes += o.reavaliacoes;
+        tempo_construcao += o.tempo_construcao;
+        tempo_busca_local += o.tempo_busca_local;
+        tempo_controle += o.tempo_controle;
+        return *this;
+    }
+};
+
+inline Contadores& contadores_thread() {
+    thread_local Contadores contadores;
+    return contadores;
+}
+
+// Soma ao campo o tempo até parar() ou até o fim do escopo.
+struct CronometroFase {
+    double* destino;
+    std::chrono::high_resolution_clock::time_point inicio = std::chrono::high_resolution_clock::now();
+
+    explicit CronometroFase(double& destino) : destino(&destino) {}
+    ~CronometroFase() { parar(); }
+
+    void parar() {
+        if (!destino) return;
+        *destino += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - inicio).count();
+        destino = nullptr;
+    }
+};
+
+// Contadores da thread, com o tempo de controle calculado a partir do tempo total.
+inline Contadores coletar_contadores(double tempo_total) {
+    Contadores c = contadores_thread();
+    c.tempo_controle = tempo_total - c.tempo_construcao - c.tempo_busca_local;
+    if (c.tempo_controle < 0) c.tempo_controle = 0;
+    return c;
+}
+
+#ifdef KPFS_INSTRUMENTACAO
+const bool INSTRUMENTACAO_ATIVA = true;
+#define CONTAR(campo) (++contadores_thread().campo)
+#define CONTAR_N(campo, n) (contadores_thread().campo += (n))
+#define FASE(campo) CronometroFase cronometro_##campo(contadores_thread().campo)
+#define INSTRUMENTAR(...) __VA_ARGS__
+#else
+const bool INSTRUMENTACAO_ATIVA = false;
+#define CONTAR(campo) ((void)0)
+#define CONTAR_N(campo, n) ((void)0)
+#define FASE(campo) ((void)0)
+#define INSTRUMENTAR(...)
+#endif
+
+// Registro de uma execução em uma linha JSON.
+inline std::string contadores_json(const Contadores& c, int valor, double tempo) {
+    std::ostringstream out;
+    out << "{\"valor\": " << valor << ", \"tempo\": " << tempo
+        << ", \"movimentos_avaliados\": " << c.movimentos_avaliados
+        << ", \"movimentos_aceitos\": " << c.movimentos_aceitos
+        << ", \"tabu_bloqueios\": " << c.tabu_bloqueios
+        << ", \"aspiracoes\": " << c.aspiracoes
+        << ", \"descidas\": " << c.descidas
+        << ", \"perturbacoes\": " << c.perturbacoes
+        << ", \"religamentos\": " << c.religamentos
+        << ", \"reavaliacoes\": " << c.reavaliacoes
+        << ", \"tempo_construcao\": " << c.tempo_construcao
+        << ", \"tempo_busca_local\": " << c.tempo_busca_local
+        << ", \"tempo_controle\": " << c.tempo_controle << "}\n";
+    return out.str();
+}
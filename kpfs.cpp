@@ -0,0 +1,88 @@
+#include "servidor.h"
+#include "solver.h"
+
+// --- Programa único: qualquer algoritmo pela interface Solver ---
+//
+//   kpfs --algo <simulated_annealing|tabu|grasp|ils> [--variante V] [--tempo s]
+//        [--semente n] [--threads n] <arquivo_entrada> [<arquivo_saida_final> <arquivo_saida_convergencia>]
+//
+// --time e --seed são aceitos como sinônimos de --tempo e --semente. Sem os
+// arquivos de saída, a linha "valor tempo limitante gap" vai para a saída
+// padrão. --threads vai de 1 ao número de núcleos; valores malformados ou fora
+// do intervalo mostram o uso.
+//
+//   kpfs --servidor [--socket caminho] [--workers n] [--cache n]
+//
+// Modo servidor (servidor.h): pedidos JSON por linha na entrada padrão (ou no
+// socket Unix), resolvidos por n workers (padrão: número de núcleos), com até
+// --cache instâncias lidas mantidas em memória (padrão 64). Algoritmo, tempo,
+// semente e threads vêm de cada pedido; as opções correspondentes são recusadas.
+
+void uso(const char* programa) {
+    cerr << "Uso: " << programa << " --algo <simulated_annealing|tabu|grasp|ils> [--variante V] [--tempo segundos]"
+         << " [--semente S] [--threads N] <arquivo_entrada> [<arquivo_saida_final> <arquivo_saida_convergencia>]\n"
+         << "     " << programa << " --servidor [--socket caminho] [--workers N] [--cache N]\n";
+    for (const string& nome : NOMES_ALGORITMOS) {
+        cerr << "  " << nome << ":";
+        for (const string& v : variantes_algoritmo(nome)) cerr << " " << v;
+        cerr << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    ConfigSolver cfg;
+    cfg.semente = semente_relogio();
+    string algo, variante, socket;
+    vector<string> posicionais;
+    bool servidor = false, opcao_de_execucao = false;  // --algo, --tempo, --semente...
+    int workers = max(1u, thread::hardware_concurrency());
+    int max_threads = workers;  // --threads, como no servidor: no máximo um por núcleo
+    int cache = 64;
+
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        bool valido = true;
+        bool tem_valor = a + 1 < argc;
+        if (arg == "--algo" && tem_valor) algo = argv[++a];
+        else if (arg == "--variante" && tem_valor) variante = argv[++a];
+        else if ((arg == "--tempo" || arg == "--time") && tem_valor) valido = ler_real_positivo(argv[++a], cfg.tempo);
+        else if ((arg == "--semente" || arg == "--seed") && tem_valor) valido = ler_natural(argv[++a], cfg.semente);
+        else if (arg == "--threads" && tem_valor) valido = ler_inteiro_entre(argv[++a], 1, max_threads, cfg.threads);
+        else if (arg == "--servidor") servidor = true;
+        else if (arg == "--socket" && tem_valor) socket = argv[++a];
+        else if (arg == "--workers" && tem_valor) valido = ler_inteiro_entre(argv[++a], 1, INT_MAX, workers);
+        else if (arg == "--cache" && tem_valor) valido = ler_inteiro_entre(argv[++a], 1, INT_MAX, cache);
+        else if (arg.size() > 1 && arg[0] == '-') valido = false;
+        else posicionais.push_back(arg);
+        opcao_de_execucao |= arg == "--tempo" || arg == "--time" || arg == "--semente" || arg == "--seed" ||
+                             arg == "--threads" || arg == "--algo" || arg == "--variante";
+        if (!valido) {
+            uso(argv[0]);
+            return 1;
+        }
+    }
+
+    if (servidor) {
+        if (!posicionais.empty() || opcao_de_execucao) {
+            // No servidor, algoritmo, tempo, semente e threads vêm de cada pedido.
+            uso(argv[0]);
+            return 1;
+        }
+        return executar_servidor(socket, workers, cache);
+    }
+
+    unique_ptr<Solver> solver = criar_solver(algo, variante);
+    if (!solver || (posicionais.size() != 1 && posicionais.size() != 3)) {
+        uso(argv[0]);
+        return 1;
+    }
+    if (posicionais.size() == 3) return executar_programa(*solver, posicionais[0], posicionais[1], posicionais[2], cfg);
+
+    Instancia entrada;
+    if (!carregar_instancia(posicionais[0], entrada)) {
+        cout << "Erro ao abrir o arquivo: " << posicionais[0] << endl;
+        return 1;
+    }
+    cout << formatar_saida(resolver_instancia(*solver, move(entrada), cfg));
+    return 0;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- Instância do KPFS (Knapsack Problem with Forfeit Sets) ---
+//
+// Compartilhada por todos os algoritmos. A adjacência item -> conjuntos fica em
+// formato CSR: os conjuntos do item i são conj_idx[conj_inicio[i] .. conj_inicio[i+1]).
+// O caminho inverso (conjunto -> itens) usa o mesmo formato em memb_inicio/memb_idx.
+// Limite (nA) e custo (fC) de cada conjunto ficam em vetores separados, de modo
+// que os laços de delta percorram só memória contígua.
+//
+// Todos os vetores apontam para um único bloco de int32, na ordem
+//   lucro[n] peso[n] lim_conj[m] custo_conj[m]
+//   conj_inicio[n+1] conj_idx[nnz] memb_inicio[m+1] memb_idx[nnz]
+// que é exatamente o corpo do formato binário .kpfsb. O bloco pertence à
+// instância (texto) ou é o próprio arquivo mapeado em memória (binário).
+
+// Contador de itens selecionados por conjunto (itemsPorConj). 32 bits: um
+// conjunto pode ter tantos membros quanto a instância tem itens.
+typedef int32_t contador_t;
+
+// Intervalo [b, e) sobre um vetor CSR, para uso em range-for.
+struct Intervalo {
+    const int* b;
+    const int* e;
+    const int* begin() const { return b; }
+    const int* end() const { return e; }
+    int size() const { return (int)(e - b); }
+};
+
+// Dados brutos de uma instância, antes do layout final.
+struct DadosInstancia {
+    int itens = 0, quant_conj = 0, capacidade = 0;
+    std::vector<int> lucro, peso;
+    std::vector<int> lim_conj, custo_conj;
+    std::vector<int> memb_inicio, memb_idx;  // conjunto -> itens (CSR)
+};
+
+struct Instancia {
+    int itens = 0, quant_conj = 0, capacidade = 0;
+    int nnz = 0;  // total de pares (item, conjunto)
+
+    const int* lucro = nullptr;
+    const int* peso = nullptr;
+    const int* lim_conj = nullptr;    // nA_i: itens permitidos sem pagar penalidade
+    const int* custo_conj = nullptr;  // fC_i: penalidade por item excedente
+    const int* conj_inicio = nullptr;
+    const int* conj_idx = nullptr;
+    const int* memb_inicio = nullptr;
+    const int* memb_idx = nullptr;
+
+    Instancia() = default;
+    Instancia(const Instancia&) = delete;
+    Instancia& operator=(const Instancia&) = delete;
+    Instancia(Instancia&&) = default;
+    Instancia& operator=(Instancia&&) = default;
+
+    Intervalo conjuntos(int item) const {
+        return {conj_idx + conj_inicio[item], conj_idx + conj_inicio[item + 1]};
+    }
+    Intervalo membros(int conj) const {
+        return {memb_idx + memb_inicio[conj], memb_idx + memb_inicio[conj + 1]};
+    }
+
+    // Tamanho do bloco de dados, em ints.
+    static size_t tamanho_bloco(int itens, int quant_conj, int nnz) {
+        return 3 * (size_t)itens + 3 * (size_t)quant_conj + 2 + 2 * (size_t)nnz;
+    }
+    size_t tamanho_bloco() const { return tamanho_bloco(itens, quant_conj, nnz); }
+
+    // As duas CSR começam em 0, não decrescem, terminam em nnz e só apontam
+    // para itens/conjuntos existentes. Uma passada linear; usada ao mapear um
+    // .kpfsb, cujo conteúdo não passou pelo montar().
+    bool csr_valida() const {
+        auto valida = [&](const int* inicio, int linhas, const int* idx, int limite) {
+            if (inicio[0] != 0 || inicio[linhas] != nnz) return false;
+            for (int k = 0; k < linhas; ++k) {
+                if (inicio[k + 1] < inicio[k]) return false;
+            }
+            for (int k = 0; k < nnz; ++k) {
+                if (idx[k] < 0 || idx[k] >= limite) return false;
+            }
+            return true;
+        };
+        return valida(conj_inicio, itens, conj_idx, quant_conj) && valida(memb_inicio, quant_conj, memb_idx, itens);
+    }
+    const int* bloco() const { return lucro; }
+
+    // Copia os dados brutos para o bloco próprio e monta conj_inicio/conj_idx
+    // (counting sort). Os conjuntos de cada item ficam em ordem crescente.
+    void montar(const DadosInstancia& d) {
+        itens = d.itens;
+        quant_conj = d.quant_conj;
+        capacidade = d.capacidade;
+        nnz = (int)d.memb_idx.size();
+        mapa.reset();
+        buffer.assign(tamanho_bloco(), 0);
+        apontar(buffer.data());
+
+        int* p = buffer.data();
+        std::copy(d.lucro.begin(), d.lucro.end(), p);
+        std::copy(d.peso.begin(), d.peso.end(), p + itens);
+        std::copy(d.lim_conj.begin(), d.lim_conj.end(), p + 2 * itens);
+        std::copy(d.custo_conj.begin(), d.custo_conj.end(), p + 2 * itens + quant_conj);
+
+        int* c_inicio = const_cast<int*>(conj_inicio);
+        int* c_idx = const_cast<int*>(conj_idx);
+        int* m_inicio = const_cast<int*>(memb_inicio);
+        std::copy(d.memb_inicio.begin(), d.memb_inicio.end(), m_inicio);
+        std::copy(d.memb_idx.begin(), d.memb_idx.end(), const_cast<int*>(memb_idx));
+
+        for (int item : d.memb_idx) c_inicio[item + 1]++;
+        for (int i = 0; i < itens; ++i) c_inicio[i + 1] += c_inicio[i];
+        std::vector<int> pos(c_inicio, c_inicio + itens);
+        for (int j = 0; j < quant_conj; ++j) {
+            for (int item : membros(j)) c_idx[pos[item]++] = j;
+        }
+    }
+
+    // Usa um bloco externo (ex.: arquivo mapeado) sem copiar.
+    void usar_bloco(std::shared_ptr<const void> dono, const int* base) {
+        buffer.clear();
+        mapa = std::move(dono);
+        apontar(base);
+    }
+
+private:
+    std::vector<int> buffer;
+    std::shared_ptr<const void> mapa;
+
+    void apontar(const int* p) {
+        lucro = p;            p += itens;
+        peso = p;             p += itens;
+        lim_conj = p;         p += quant_conj;
+        custo_conj = p;       p += quant_conj;
+        conj_inicio = p;      p += itens + 1;
+        conj_idx = p;         p += nnz;
+        memb_inicio = p;      p += quant_conj + 1;
+        memb_idx = p;
+    }
+};
+
+// --- Formato binário .kpfsb ---
+const char MAGICA_BINARIO[4] = {'K', 'P', 'F', 'S'};
+const uint32_t VERSAO_BINARIO = 1;
+
+struct CabecalhoBinario {
+    char magica[4];
+    uint32_t versao;
+    int32_t itens, quant_conj, capacidade, nnz;
+    uint32_t reservado[2];
+};
+static_assert(sizeof(CabecalhoBinario) == 32, "cabecalho .kpfsb deve ter 32 bytes");
+
+// Mapeia um arquivo inteiro em memória (somente leitura).
+inline std::shared_ptr<const char> mapear_arquivo(const std::string& caminho, size_t& tamanho) {
+    int fd = open(caminho.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    tamanho = (size_t)st.st_size;
+    void* p = mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return nullptr;
+    size_t n = tamanho;
+    return std::shared_ptr<const char>((const char*)p, [n](const char* q) { munmap((void*)q, n); });
+}
+
+// Leitor de inteiros sobre o texto mapeado.
+struct LeitorTexto {
+    const char* p;
+    const char* fim;
+    bool ok = true;
+
+    int proximo() {
+        while (p < fim && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+        int v = 0;
+        auto [q, ec] = std::from_chars(p, fim, v);
+        if (ec != std::errc()) ok = false;
+        p = q;
+        return v;
+    }
+};
+
+// Lê uma instância no formato texto descrito em instances/readme.txt a partir
+// do texto em [inicio, fim).
+inline bool ler_instancia_texto(const char* inicio, const char* fim, Instancia& inst) {
+    LeitorTexto in{inicio, fim};
+    DadosInstancia d;
+    d.itens = in.proximo();
+    d.quant_conj = in.proximo();
+    d.capacidade = in.proximo();
+    if (!in.ok || d.itens < 0 || d.quant_conj < 0 || d.capacidade < 0) return false;
+
+    d.lucro.resize(d.itens);
+    d.peso.resize(d.itens);
+    for (int j = 0; j < d.itens; j++) d.lucro[j] = in.proximo();
+    for (int j = 0; j < d.itens; j++) d.peso[j] = in.proximo();
+
+    d.lim_conj.resize(d.quant_conj);
+    d.custo_conj.resize(d.quant_conj);
+    d.memb_inicio.assign(d.quant_conj + 1, 0);
+    for (int j = 0; j < d.quant_conj; j++) {
+        d.lim_conj[j] = in.proximo();
+        d.custo_conj[j] = in.proximo();
+        int itens_conj = in.proximo();
+        if (!in.ok || itens_conj < 0) return false;
+        for (int k = 0; k < itens_conj; k++) {
+            int item = in.proximo();
+            if (item < 0 || item >= d.itens) return false;
+            d.memb_idx.push_back(item);
+        }
+        d.memb_inicio[j + 1] = (int)d.memb_idx.size();
+    }
+    if (!in.ok) return false;
+
+    inst.montar(d);
+    return true;
+}
+
+inline bool carregar_instancia_texto(const std::string& caminho, Instancia& inst) {
+    size_t tamanho = 0;
+    auto mapa = mapear_arquivo(caminho, tamanho);
+    return mapa && ler_instancia_texto(mapa.get(), mapa.get() + tamanho, inst);
+}
+
+// Mapeia um arquivo .kpfsb e aponta a instância diretamente para ele.
+inline bool carregar_instancia_binaria(const std::string& caminho, Instancia& inst) {
+    size_t tamanho = 0;
+    auto mapa = mapear_arquivo(caminho, tamanho);
+    if (!mapa || tamanho < sizeof(CabecalhoBinario)) return false;
+
+    CabecalhoBinario cab;
+    std::memcpy(&cab, mapa.get(), sizeof(cab));
+    if (std::memcmp(cab.magica, MAGICA_BINARIO, 4) != 0 || cab.versao != VERSAO_BINARIO) return false;
+    if (cab.itens < 0 || cab.quant_conj < 0 || cab.nnz < 0 || cab.capacidade < 0) return false;
+    if (tamanho != sizeof(cab) + Instancia::tamanho_bloco(cab.itens, cab.quant_conj, cab.nnz) * sizeof(int32_t)) return false;
+
+    inst.itens = cab.itens;
+    inst.quant_conj = cab.quant_conj;
+    inst.capacidade = cab.capacidade;
+    inst.nnz = cab.nnz;
+    const int* base = (const int*)(mapa.get() + sizeof(cab));
+    inst.usar_bloco(std::move(mapa), base);
+    return inst.csr_valida();
+}
+
+inline bool eh_arquivo_binario(const std::string& caminho) {
+    return caminho.size() >= 6 && caminho.compare(caminho.size() - 6, 6, ".kpfsb") == 0;
+}
+
+// Escolhe o leitor pela extensão (.kpfsb = binário; qualquer outra = texto).
+// Retorna false se o arquivo não puder ser aberto ou estiver malformado.
+inline bool carregar_instancia(const std::string& caminho, Instancia& inst) {
+    return eh_arquivo_binario(caminho) ? carregar_instancia_binaria(caminho, inst)
+                                       : carregar_instancia_texto(caminho, inst);
+}
+
+inline bool salvar_instancia_binaria(const Instancia& inst, const std::string& caminho) {
+    std::ofstream arquivo(caminho, std::ios::binary | std::ios::trunc);
+    if (!arquivo.is_open()) return false;
+
+    CabecalhoBinario cab{};
+    std::memcpy(cab.magica, MAGICA_BINARIO, 4);
+    cab.versao = VERSAO_BINARIO;
+    cab.itens = inst.itens;
+    cab.quant_conj = inst.quant_conj;
+    cab.capacidade = inst.capacidade;
+    cab.nnz = inst.nnz;
+    arquivo.write((const char*)&cab, sizeof(cab));
+    arquivo.write((const char*)inst.bloco(), inst.tamanho_bloco() * sizeof(int32_t));
+    return (bool)arquivo;
+}
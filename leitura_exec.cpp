@@ -1,94 +1,483 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
-#include <filesystem>
-#include <cstdlib>
-#include <iomanip>
 
-int main() {
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "armazem.h"
+#include "diario.h"
+#include "solver.h"
+
+// --- Execução da campanha de experimentos ---
+//
+// Todos os algoritmos rodam neste processo (solver.h), em um pool de
+// threads. Cada trabalho é (instância, run, algoritmo). Os trabalhos são
+// gerados em ordem de instância e distribuídos em rodízio entre as filas dos
+// workers; quem esvazia a própria fila rouba do fim da fila de outro. Assim os
+// workers tendem a trabalhar na mesma instância ao mesmo tempo: ela é lida uma
+// vez (já reduzida pelo presolve, reducao.h), compartilhada (só leitura) e
+// liberada quando seu último trabalho termina.
+//
+// Por padrão cada execução vira um registro do armazém da campanha
+// (armazem.h, resultados/campanha.kpfsr), gravado em blocos conforme os
+// trabalhos terminam; ./exportar gera a partir dele o layout em texto.
+//
+// Com --formato texto, o layout em texto é escrito direto: cada arquivo
+// saida_<tamanho>.txt agrega as instâncias de um grupo (run, algoritmo, tipo,
+// tamanho). Os resultados ficam num buffer por trabalho e o arquivo é escrito
+// de uma vez, na ordem cenário/arquivo do laço sequencial, quando o grupo
+// termina; o resultado não depende da ordem de execução.
+//
+// Os trabalhos concluídos vão para o diário da campanha (diario.h), com fsync:
+// no formato binário, quando o bloco do armazém que os contém está no disco;
+// no texto, depois de gravar o conv_*.txt do trabalho. Com --retomar, a
+// campanha continua de onde o diário parou: mesma semente base, só os
+// trabalhos que faltam vão para as filas, o armazém é cortado no último bloco
+// confirmado e, no formato texto, os grupos já completos são reescritos a
+// partir do diário.
+double tempoLimite = 2.0;
+
+struct EntradaInstancia {
+    std::string caminho;
+    std::mutex trava;
+    std::shared_ptr<const Reducao> reducao;
+    int limitante = INT_MAX;  // da instância reduzida, calculado junto com a leitura
+    bool falhou = false;
+    std::atomic<int> restantes{0};
+
+    // Lê, reduz e calcula o limitante na primeira chamada; as demais esperam
+    // e reaproveitam.
+    std::shared_ptr<const Reducao> obter() {
+        std::lock_guard<std::mutex> lock(trava);
+        if (!reducao && !falhou) {
+            Instancia lida;
+            if (carregar_instancia(caminho, lida)) {
+                auto nova = std::make_shared<Reducao>(std::move(lida));
+                limitante = limitante_superior(nova->inst);
+                reducao = nova;
+            } else {
+                falhou = true;
+            }
+        }
+        return reducao;
+    }
+
+    void liberar() {
+        if (restantes.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(trava);
+            reducao.reset();
+        }
+    }
+};
+
+struct Grupo {
+    std::string saida;
+    std::string descricao;
+    std::vector<Resultado> resultados;  // um por instância, na ordem canônica
+    std::vector<std::string> contadores;  // linha JSON de cada resultado
+    std::vector<char> ok;
+    std::atomic<int> restantes{0};
+};
+
+struct Trabalho {
+    int instancia;
+    int run;
+    int algoritmo;
+    int grupo;
+    int posicao;  // posição no grupo
+};
+
+struct FilaTrabalho {
+    std::mutex trava;
+    std::deque<int> itens;
+};
+
+// Semente de um trabalho: mistura (splitmix64) da semente base com a chave.
+uint64_t semente_trabalho(uint64_t base, int instancia, int run, int algoritmo) {
+    uint64_t z = base ^ ((uint64_t)instancia << 32) ^ ((uint64_t)run << 8) ^ (uint64_t)algoritmo;
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void fixar_cpu(int worker) {
+#ifdef __linux__
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    CPU_SET(worker % (int)std::max(1u, std::thread::hardware_concurrency()), &conjunto);
+    pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto);
+#else
+    (void)worker;
+#endif
+}
+
+int main(int argc, char* argv[]) {
     // --- Configuração dos Experimentos ---
-    const std::vector<std::string> algorithmNames = {"simulated_annealing", "tabu", "grasp", "ils"};
-    
+    const std::vector<std::string>& algorithmNames = NOMES_ALGORITMOS;
+    std::vector<std::unique_ptr<Solver>> solvers;
+    for (const std::string& nome : algorithmNames) solvers.push_back(criar_solver(nome));
+
     const std::vector<std::string> instanceTypes = {"correlated_sc", "fully_correlated_sc", "not_correlated_sc"};
     const std::vector<std::string> instanceSizes = {"300", "500", "700", "800", "1000"};
     const int totalScenarios = 4;
     const int totalFilesPerConfig = 10;
-    const int totalRuns = 30;
-
-    // --- Verificação Pré-Execução ---
-    std::cout << "Verificando a existência dos executáveis...\n";
-    for (const std::string& algoName : algorithmNames) {
-        if (!std::filesystem::exists(algoName)) {
-            std::cerr << "ERRO FATAL: O executável '" << algoName << "' não foi encontrado.\n"
-                      << "Certifique-se de que todos os algoritmos foram compilados com otimização.\n";
+    int totalRuns = 30;
+
+    const int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    int numThreads = maxThreads;  // --threads: de 1 ao número de núcleos
+    bool fixarCpu = false;
+    bool formatoTexto = false;
+    bool retomar = false, sementeDada = false;
+    std::string caminhoArmazem = "resultados/campanha.kpfsr";
+    std::string caminhoDiario = "resultados/campanha.diario";
+    uint64_t sementeBase = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        bool valido = true;
+        if (arg == "--threads" && a + 1 < argc) valido = ler_inteiro_entre(argv[++a], 1, maxThreads, numThreads);
+        else if (arg == "--runs" && a + 1 < argc) valido = ler_inteiro_entre(argv[++a], 1, INT_MAX, totalRuns);
+        else if (arg == "--semente" && a + 1 < argc) valido = sementeDada = ler_natural(argv[++a], sementeBase);
+        else if (arg == "--tempo" && a + 1 < argc) valido = ler_real_positivo(argv[++a], tempoLimite);
+        else if (arg == "--fixar-cpu") fixarCpu = true;
+        else if (arg == "--armazem" && a + 1 < argc) caminhoArmazem = argv[++a];
+        else if (arg == "--diario" && a + 1 < argc) caminhoDiario = argv[++a];
+        else if (arg == "--retomar") retomar = true;
+        else if (arg == "--formato" && a + 1 < argc) {
+            std::string formato = argv[++a];
+            formatoTexto = formato == "texto";
+            valido = formatoTexto || formato == "binario";
+        }
+        else valido = false;
+        if (!valido) {
+            std::cerr << "Uso: " << argv[0] << " [--threads N] [--runs N] [--semente S] [--tempo segundos] [--fixar-cpu]"
+                      << " [--formato binario|texto] [--armazem arquivo] [--diario arquivo] [--retomar]\n";
             return 1;
         }
     }
-    std::cout << "Todos os executáveis foram encontrados. Iniciando os testes.\n";
 
-    // --- Loop Principal dos Experimentos ---
+    // --- Diário de uma execução anterior ---
+    EstadoDiario anterior;
+    bool retomando = retomar && ler_diario(caminhoDiario, anterior);
+    const std::string formato = formatoTexto ? "texto" : "binario";
+    if (retomando && anterior.formato != formato) {
+        std::cerr << "O diário " << caminhoDiario << " é de uma campanha no formato " << anterior.formato << ".\n";
+        return 1;
+    }
+    if (retomando && sementeDada && sementeBase != anterior.semente_base) {
+        std::cerr << "O diário " << caminhoDiario << " é de uma campanha com semente " << anterior.semente_base
+                  << "; retome sem --semente ou com a mesma semente.\n";
+        return 1;
+    }
+    if (retomando) sementeBase = anterior.semente_base;
+
+    // --- Instâncias existentes, na ordem do laço original ---
+    std::vector<std::unique_ptr<EntradaInstancia>> instancias;
+    struct Origem {
+        int scenario, tipo, tamanho, arquivo;
+    };
+    std::vector<Origem> origens;
+    auto chave_trabalho = [&](int instancia, int run, int alg) {
+        const Origem& o = origens[instancia];
+        ChaveExecucao c;
+        c.run = run;
+        c.algoritmo = algorithmNames[alg];
+        c.cenario = o.scenario;
+        c.tipo = instanceTypes[o.tipo];
+        c.tamanho = std::stoi(instanceSizes[o.tamanho]);
+        c.arquivo = o.arquivo;
+        return c;
+    };
+    for (int scenario = 1; scenario <= totalScenarios; ++scenario) {
+        for (int t = 0; t < (int)instanceTypes.size(); ++t) {
+            for (int z = 0; z < (int)instanceSizes.size(); ++z) {
+                for (int fileNum = 1; fileNum <= totalFilesPerConfig; ++fileNum) {
+                    std::string inputFile = "instances/scenario" + std::to_string(scenario) + "/" + instanceTypes[t] +
+                                            std::to_string(scenario) + "/" + instanceSizes[z] + "/kpfs_" +
+                                            std::to_string(fileNum) + ".txt";
+                    if (!std::filesystem::exists(inputFile)) {
+                        std::cout << "Instância não encontrada: " << inputFile << "\n";
+                        continue;
+                    }
+                    instancias.push_back(std::make_unique<EntradaInstancia>());
+                    instancias.back()->caminho = inputFile;
+                    origens.push_back({scenario, t, z, fileNum});
+                }
+            }
+        }
+    }
+
+    // --- Grupos de saída: (run, algoritmo, tipo, tamanho) ---
+    const int numAlg = (int)algorithmNames.size();
+    const int numTipos = (int)instanceTypes.size();
+    const int numTamanhos = (int)instanceSizes.size();
+    auto indice_grupo = [&](int run, int alg, int tipo, int tamanho) {
+        return (((run - 1) * numAlg + alg) * numTipos + tipo) * numTamanhos + tamanho;
+    };
+    std::vector<std::unique_ptr<Grupo>> grupos(totalRuns * numAlg * numTipos * numTamanhos);
     for (int run = 1; run <= totalRuns; ++run) {
-        std::cout << "\n======================================================\n"
-                  << "===                INICIANDO RUN " << std::setw(2) << run << " / " << totalRuns << "                ===\n"
-                  << "======================================================\n";
-
-        for (const std::string& algoName : algorithmNames) {
-            std::cout << "\n[Algoritmo: " << algoName << "]\n";
-
-            for (int scenario = 1; scenario <= totalScenarios; ++scenario) {
-                for (const std::string& type : instanceTypes) {
-                    for (const std::string& size : instanceSizes) {
-                        
-                        // --- DEFINIÇÃO DOS CAMINHOS DE SAÍDA ---
-                        // Diretório para resultados finais (valor e tempo)
-                        std::string outputDirFinal = "./resultados/run_" + std::to_string(run) + "/" + algoName + "/" + type;
-                        // Diretório para dados de convergência (histórico)
-                        std::string outputDirConv = "./convergencia/run_" + std::to_string(run) + "/" + algoName + "/" + type;
-                        
-                        std::filesystem::create_directories(outputDirFinal);
-                        std::filesystem::create_directories(outputDirConv);
-
-                        // O arquivo de resultado final agrega as 10 instâncias da mesma configuração
-                        std::string outputFileFinal = outputDirFinal + "/saida_" + size + ".txt";
-
-                        std::cout << "  > Cenário " << scenario << " | "
-                                  << std::setw(20) << std::left << type 
-                                  << "| Tamanho " << std::setw(4) << size << ": " << std::flush;
-
-                        for (int fileNum = 1; fileNum <= totalFilesPerConfig; ++fileNum) {
-                            // Constrói o caminho do arquivo de entrada
-                            std::string inputFile = "instances/scenario" + std::to_string(scenario) +
-                                                   "/" + type + std::to_string(scenario) +
-                                                   "/" + size + "/kpfs_" + std::to_string(fileNum) + ".txt";
-
-                            if (!std::filesystem::exists(inputFile)) {
-                                std::cout << "X" << std::flush;
-                                continue;
-                            }
-
-                            // Constrói o nome do arquivo de convergência, único para esta instância e run
-                             std::string convFileName = "conv_s" + std::to_string(scenario) 
-                                                     + "_t" + type 
-                                                     + "_z" + size 
-                                                     + "_f" + std::to_string(fileNum) + ".txt";
-                            std::string outputFileConv = outputDirConv + "/" + convFileName;
-
-
-                            // Monta e executa o comando com os 3 caminhos de arquivo
-                            std::string command = "./" + algoName + " " + inputFile + " " + outputFileFinal + " " + outputFileConv;
-                            
-                            system(command.c_str());
-                            std::cout << "." << std::flush; // Imprime um ponto para cada arquivo processado
-                        }
-                        std::cout << " Concluído.\n"; // Fim da linha para esta configuração
+        for (int alg = 0; alg < numAlg; ++alg) {
+            std::string outputDirFinal = "./resultados/run_" + std::to_string(run) + "/" + algorithmNames[alg];
+            std::string outputDirConv = "./convergencia/run_" + std::to_string(run) + "/" + algorithmNames[alg];
+            for (int t = 0; t < numTipos; ++t) {
+                if (formatoTexto) {
+                    std::filesystem::create_directories(outputDirFinal + "/" + instanceTypes[t]);
+                    std::filesystem::create_directories(outputDirConv + "/" + instanceTypes[t]);
+                }
+                for (int z = 0; z < numTamanhos; ++z) {
+                    auto g = std::make_unique<Grupo>();
+                    g->saida = outputDirFinal + "/" + instanceTypes[t] + "/saida_" + instanceSizes[z] + ".txt";
+                    g->descricao = "run " + std::to_string(run) + " | " + algorithmNames[alg] + " | " +
+                                   instanceTypes[t] + " | tamanho " + instanceSizes[z];
+                    grupos[indice_grupo(run, alg, t, z)] = std::move(g);
+                }
+            }
+        }
+    }
+
+    // --- Trabalhos, em ordem de instância ---
+    std::vector<Trabalho> trabalhos;
+    for (int i = 0; i < (int)instancias.size(); ++i) {
+        const Origem& o = origens[i];
+        for (int run = 1; run <= totalRuns; ++run) {
+            for (int alg = 0; alg < numAlg; ++alg) {
+                Grupo& g = *grupos[indice_grupo(run, alg, o.tipo, o.tamanho)];
+                trabalhos.push_back({i, run, alg, indice_grupo(run, alg, o.tipo, o.tamanho), (int)g.ok.size()});
+                if (formatoTexto) {
+                    g.resultados.emplace_back();
+                    g.contadores.emplace_back();
+                }
+                g.ok.push_back(0);
+                g.restantes++;
+                instancias[i]->restantes++;
+            }
+        }
+    }
+    int gruposAtivos = 0;
+    for (const auto& g : grupos) gruposAtivos += g->restantes > 0;
+
+    // --- Trabalhos já confirmados no diário (mesma chave e mesma semente) ---
+    std::vector<char> concluido(trabalhos.size(), 0);
+    int jaConcluidos = 0;
+    if (retomando) {
+        std::map<ChaveExecucao, int> porChave;
+        for (int j = 0; j < (int)trabalhos.size(); ++j) {
+            porChave[chave_trabalho(trabalhos[j].instancia, trabalhos[j].run, trabalhos[j].algoritmo)] = j;
+        }
+        for (RegistroExecucao& r : anterior.concluidos) {
+            auto it = porChave.find(r.chave);
+            if (it == porChave.end() || concluido[it->second]) continue;
+            const Trabalho& tr = trabalhos[it->second];
+            if (r.semente != semente_trabalho(sementeBase, tr.instancia, tr.run, tr.algoritmo)) continue;
+            concluido[it->second] = 1;
+            jaConcluidos++;
+            Grupo& g = *grupos[tr.grupo];
+            g.ok[tr.posicao] = 1;
+            if (formatoTexto) {
+                g.resultados[tr.posicao] = r.resultado;
+                g.contadores[tr.posicao] = r.contadores;
+            }
+            g.restantes--;
+            instancias[tr.instancia]->restantes--;
+        }
+    }
+
+    // --- Diário e armazém: novos, ou continuados do ponto confirmado ---
+    for (const std::string& caminho : {caminhoDiario, caminhoArmazem}) {
+        std::filesystem::path pasta = std::filesystem::path(caminho).parent_path();
+        if (!pasta.empty()) std::filesystem::create_directories(pasta);
+    }
+    DiarioCampanha diario;
+    if (!(retomando ? diario.continuar(caminhoDiario, anterior) : diario.criar(caminhoDiario, sementeBase, formato))) {
+        std::cerr << "Erro ao abrir o diário " << caminhoDiario << "\n";
+        return 1;
+    }
+    EscritorArmazem armazem;
+    if (!formatoTexto) {
+        armazem.ao_gravar = [&](const std::vector<RegistroExecucao>& bloco, uint64_t fim) {
+            return diario.confirmar(bloco, fim);
+        };
+        if (!armazem.abrir(caminhoArmazem, retomando, retomando ? anterior.fim_armazem : UINT64_MAX)) {
+            std::cerr << "Erro ao abrir o armazém " << caminhoArmazem << "\n";
+            if (retomando) {
+                std::cerr << "O diário confirma execuções que não estão no armazém (ausente ou danificado); "
+                          << "rode sem --retomar para recomeçar a campanha.\n";
+            }
+            return 1;
+        }
+    }
+
+    std::cout << trabalhos.size() << " execuções (" << instancias.size() << " instâncias, " << totalRuns
+              << " runs, " << numAlg << " algoritmos) em " << numThreads << " threads.\n";
+    if (retomando) {
+        std::cout << "Retomando " << caminhoDiario << " (semente " << sementeBase << "): " << jaConcluidos
+                  << " execuções já concluídas, " << trabalhos.size() - jaConcluidos << " restantes.\n";
+    }
+
+    // --- Pool com roubo de trabalho ---
+    std::vector<FilaTrabalho> filas(numThreads);
+    int pendentes = 0;
+    for (int j = 0; j < (int)trabalhos.size(); ++j) {
+        if (!concluido[j]) filas[pendentes++ % numThreads].itens.push_back(j);
+    }
+
+    std::mutex travaSaida;
+    int gruposConcluidos = 0;
+    bool erro = false;
+
+    auto pegar = [&](int w, int& j) {
+        {
+            std::lock_guard<std::mutex> lock(filas[w].trava);
+            if (!filas[w].itens.empty()) {
+                j = filas[w].itens.front();
+                filas[w].itens.pop_front();
+                return true;
+            }
+        }
+        for (int d = 1; d < numThreads; ++d) {
+            FilaTrabalho& vitima = filas[(w + d) % numThreads];
+            std::lock_guard<std::mutex> lock(vitima.trava);
+            if (!vitima.itens.empty()) {
+                j = vitima.itens.back();
+                vitima.itens.pop_back();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto concluir_grupo = [&](Grupo& g) {
+        if (!formatoTexto) {
+            std::lock_guard<std::mutex> lock(travaSaida);
+            gruposConcluidos++;
+            std::cout << "  [" << std::setw(4) << gruposConcluidos << "/" << gruposAtivos << "] " << g.descricao
+                      << ": Concluído.\n"
+                      << std::flush;
+            return;
+        }
+        std::string conteudo, contadores;
+        for (size_t k = 0; k < g.resultados.size(); ++k) {
+            if (!g.ok[k]) continue;
+            conteudo += formatar_saida(g.resultados[k]);
+            contadores += g.contadores[k];
+        }
+        std::ofstream arquivo(g.saida);
+        arquivo << conteudo;
+        if (INSTRUMENTACAO_ATIVA) {
+            std::ofstream arquivo_contadores(caminho_contadores(g.saida));
+            arquivo_contadores << contadores;
+            if (!arquivo_contadores) arquivo.setstate(std::ios::failbit);
+        }
+        std::lock_guard<std::mutex> lock(travaSaida);
+        if (!arquivo) {
+            std::cerr << "Erro ao escrever " << g.saida << "\n";
+            erro = true;
+        }
+        gruposConcluidos++;
+        std::cout << "  [" << std::setw(4) << gruposConcluidos << "/" << gruposAtivos << "] " << g.descricao
+                  << ": Concluído.\n"
+                  << std::flush;
+    };
+
+    std::mutex travaAtivos;
+    std::condition_variable fimWorker;
+    int ativos = numThreads;
+
+    auto worker = [&](int w) {
+        if (fixarCpu) fixar_cpu(w);
+        int j;
+        while (pegar(w, j)) {
+            const Trabalho& tr = trabalhos[j];
+            EntradaInstancia& entrada = *instancias[tr.instancia];
+            Grupo& g = *grupos[tr.grupo];
+
+            std::shared_ptr<const Reducao> reducao = entrada.obter();
+            if (reducao) {
+                ConfigSolver cfg;
+                cfg.tempo = tempoLimite;
+                cfg.semente = semente_trabalho(sementeBase, tr.instancia, tr.run, tr.algoritmo);
+                cfg.limitante = entrada.limitante;
+                Resultado resultado = resolver_reduzida(*solvers[tr.algoritmo], *reducao, cfg);
+                RegistroExecucao registro{chave_trabalho(tr.instancia, tr.run, tr.algoritmo), cfg.semente,
+                                          std::move(resultado), ""};
+                if (INSTRUMENTACAO_ATIVA) registro.contadores = formatar_contadores(registro.resultado);
+                g.ok[tr.posicao] = 1;
+                if (formatoTexto) {
+                    bool gravado = escrever_duravel(caminho_convergencia(".", registro.chave),
+                                                    formatar_convergencia(registro.resultado)) &&
+                                   diario.confirmar({registro}, 0);
+                    if (!gravado) {
+                        std::lock_guard<std::mutex> lock(travaSaida);
+                        std::cerr << "Erro ao gravar " << caminho_convergencia(".", registro.chave) << " ou o diário\n";
+                        erro = true;
                     }
+                    g.contadores[tr.posicao] = std::move(registro.contadores);
+                    g.resultados[tr.posicao] = std::move(registro.resultado);
+                } else {
+                    armazem.adicionar(std::move(registro));
                 }
+            } else {
+                std::lock_guard<std::mutex> lock(travaSaida);
+                std::cerr << "Erro ao abrir o arquivo: " << entrada.caminho << "\n";
+                erro = true;
             }
+            reducao.reset();
+            entrada.liberar();
+
+            if (g.restantes.fetch_sub(1) == 1) concluir_grupo(g);
+        }
+        {
+            std::lock_guard<std::mutex> lock(travaAtivos);
+            ativos--;
         }
+        fimWorker.notify_one();
+    };
+
+    // Grupos que o diário já completa: reescritos, o que também desfaz um
+    // saida_*.txt que tenha ficado pela metade.
+    for (const auto& g : grupos) {
+        if (!g->ok.empty() && g->restantes == 0) concluir_grupo(*g);
+    }
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < numThreads; ++w) threads.emplace_back(worker, w);
+    // Enquanto os workers rodam, o bloco pendente do armazém é gravado quando
+    // vence o intervalo, mesmo que nenhuma execução termine nesse meio tempo.
+    {
+        std::unique_lock<std::mutex> lock(travaAtivos);
+        while (!fimWorker.wait_for(lock, std::chrono::seconds(1), [&] { return ativos == 0; })) {
+            lock.unlock();
+            if (!formatoTexto) armazem.descarregar_vencido();
+            lock.lock();
+        }
+    }
+    for (std::thread& t : threads) t.join();
+    if (!formatoTexto && !armazem.fechar()) {
+        std::cerr << "Erro ao escrever o armazém " << caminhoArmazem << "\n";
+        erro = true;
     }
 
     std::cout << "\n\n******************************************************\n"
               << "*   Todos os experimentos foram concluídos!          *\n"
               << "******************************************************\n";
-    return 0;
-}
\ No newline at end of file
+    return erro ? 1 : 0;
+}
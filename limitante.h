@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "kpfs.h"
+
+// --- Limitantes superiores para o KPFS ---
+//
+// Dantzig: relaxação linear da mochila pura (lucro, peso, capacidade). As
+// penalidades dos conjuntos são >= 0, então ignorá-las só pode aumentar o valor.
+//
+// Lagrangeano: com v_j >= excesso do conjunto j, o KPFS é
+//   max sum p_i x_i - sum c_j v_j,  sum_{i em j} x_i - v_j <= lim_j,  peso <= C.
+// Relaxando a restrição de cada conjunto com multiplicador 0 <= u_j <= c_j, o
+// termo de v_j fica (u_j - c_j) v_j <= 0 (v_j = 0 é ótimo) e sobra
+//   L(u) = sum u_j lim_j + Dantzig(p_i - sum_{j em i} u_j),
+// que é limitante para todo u. u = 0 dá o limitante de Dantzig; os
+// multiplicadores são ajustados por subgradiente (passo de Polyak, tendo como
+// alvo o valor da parte inteira da solução da relaxação, que é viável).
+//
+// Os valores do KPFS são inteiros, então o limitante é arredondado para baixo.
+
+const int LIMITANTE_MAX_ITER = 100;       // iterações de subgradiente
+const int LIMITANTE_PACIENCIA = 3;        // sem melhora antes de reduzir o passo
+const double LIMITANTE_PASSO_MIN = 1e-3;  // fator do passo abaixo do qual para
+
+struct Limitantes {
+    int dantzig = INT_MAX;
+    int lagrangeano = INT_MAX;
+    int melhor() const { return std::min(dantzig, lagrangeano); }
+};
+
+// Gap relativo de 'valor' até o limitante (0 quando provadamente ótimo).
+inline double gap_otimalidade(int valor, int limitante) {
+    if (limitante == INT_MAX) return 1.0;
+    if (valor >= limitante) return 0.0;
+    return (double)(limitante - valor) / std::max(1, std::abs(limitante));
+}
+
+namespace detalhe_limitante {
+
+// Relaxação linear da mochila com lucros 'lucro': valor, e em x a solução
+// fracionária. 'ordem' é área de trabalho.
+inline double dantzig(const Instancia& inst, const std::vector<double>& lucro, std::vector<double>& x, std::vector<int>& ordem) {
+    ordem.clear();
+    double valor = 0;
+    double folga = inst.capacidade;
+    std::fill(x.begin(), x.end(), 0.0);
+    for (int i = 0; i < inst.itens; ++i) {
+        if (lucro[i] <= 0) continue;
+        if (inst.peso[i] == 0) {
+            x[i] = 1;
+            valor += lucro[i];
+        } else {
+            ordem.push_back(i);
+        }
+    }
+    std::sort(ordem.begin(), ordem.end(), [&](int a, int b) {
+        return lucro[a] * inst.peso[b] > lucro[b] * inst.peso[a];
+    });
+    for (int i : ordem) {
+        if (inst.peso[i] <= folga) {
+            x[i] = 1;
+            valor += lucro[i];
+            folga -= inst.peso[i];
+        } else {
+            x[i] = folga / inst.peso[i];
+            valor += lucro[i] * x[i];
+            break;
+        }
+    }
+    return valor;
+}
+
+// Valor no KPFS dos itens com x == 1 (respeitam a capacidade).
+inline int valor_inteiro(const Instancia& inst, const std::vector<double>& x, std::vector<int>& contagem) {
+    std::fill(contagem.begin(), contagem.end(), 0);
+    int valor = 0;
+    for (int i = 0; i < inst.itens; ++i) {
+        if (x[i] < 1) continue;
+        valor += inst.lucro[i];
+        for (int cj : inst.conjuntos(i)) contagem[cj]++;
+    }
+    for (int j = 0; j < inst.quant_conj; ++j) {
+        if (contagem[j] > inst.lim_conj[j]) valor -= (contagem[j] - inst.lim_conj[j]) * inst.custo_conj[j];
+    }
+    return valor;
+}
+
+inline int arredondar(double limitante) { return (int)std::min<double>(INT_MAX - 1, std::floor(limitante + 1e-6)); }
+
+}  // namespace detalhe_limitante
+
+inline Limitantes calcular_limitantes(const Instancia& inst, int max_iter = LIMITANTE_MAX_ITER) {
+    using namespace detalhe_limitante;
+    Limitantes r;
+    std::vector<double> lucro(inst.lucro, inst.lucro + inst.itens), x(inst.itens), u(inst.quant_conj, 0.0);
+    std::vector<double> subgradiente(inst.quant_conj);
+    std::vector<int> ordem, contagem(inst.quant_conj);
+    ordem.reserve(inst.itens);
+
+    double melhor = dantzig(inst, lucro, x, ordem);
+    r.dantzig = arredondar(melhor);
+    double viavel = valor_inteiro(inst, x, contagem);
+
+    double fator = 1.0;
+    int sem_melhora = 0;
+    double valor = melhor;
+    for (int it = 0; it < max_iter && fator > LIMITANTE_PASSO_MIN && melhor - viavel >= 1 - 1e-6; ++it) {
+        // subgradiente de L em u: lim_j - sum_{i em j} x_i
+        double norma = 0;
+        for (int j = 0; j < inst.quant_conj; ++j) {
+            double soma = 0;
+            for (int i : inst.membros(j)) soma += x[i];
+            double g = inst.lim_conj[j] - soma;
+            // projeção em [0, c_j]: direções que sairiam da caixa não contam
+            if ((u[j] <= 0 && g > 0) || (u[j] >= inst.custo_conj[j] && g < 0)) g = 0;
+            subgradiente[j] = g;
+            norma += g * g;
+        }
+        if (norma == 0) break;  // u é ótimo para o dual
+        double passo = fator * (valor - viavel) / norma;
+        for (int j = 0; j < inst.quant_conj; ++j) {
+            u[j] = std::min<double>(inst.custo_conj[j], std::max(0.0, u[j] - passo * subgradiente[j]));
+        }
+
+        double constante = 0;
+        for (int j = 0; j < inst.quant_conj; ++j) constante += u[j] * inst.lim_conj[j];
+        for (int i = 0; i < inst.itens; ++i) {
+            double p = inst.lucro[i];
+            for (int cj : inst.conjuntos(i)) p -= u[cj];
+            lucro[i] = p;
+        }
+        valor = constante + dantzig(inst, lucro, x, ordem);
+        viavel = std::max<double>(viavel, valor_inteiro(inst, x, contagem));
+        if (valor < melhor - 1e-9) {
+            melhor = valor;
+            sem_melhora = 0;
+        } else if (++sem_melhora >= LIMITANTE_PACIENCIA) {
+            fator /= 2;
+            sem_melhora = 0;
+        }
+    }
+    r.lagrangeano = arredondar(melhor);
+    return r;
+}
+
+// O menor dos dois limitantes.
+inline int limitante_superior(const Instancia& inst) { return calcular_limitantes(inst).melhor(); }
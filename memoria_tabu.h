@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// --- Memórias da busca tabu ---
+//
+// Todas têm a mesma interface:
+//   tabu(hash_vizinho, item, iter)   o movimento que inverte 'item' é tabu?
+//   registrar(hash_nova, item, iter) chamado depois de aplicar o movimento
+//   bytes()                          memória ocupada (aproximada)
+// hash_* é o hash Zobrist da solução (xor de um aleatório por item selecionado).
+// com_memoria_tabu() escolhe a implementação em tempo de execução.
+
+// Soluções visitadas num std::map, sem expiração (implementação original).
+struct MemoriaTabuMap {
+    std::map<long long, long long> visitadas;  // hash -> iteração até a qual é tabu
+    int tenure;
+
+    MemoriaTabuMap(int itens, int tenure) : tenure(tenure) { (void)itens; }
+
+    bool tabu(long long hash, int item, int iter) const {
+        (void)item;
+        auto it = visitadas.find(hash);
+        return it != visitadas.end() && it->second > iter;
+    }
+    void registrar(long long hash, int item, int iter) {
+        (void)item;
+        visitadas[hash] = iter + tenure;
+    }
+    size_t bytes() const { return visitadas.size() * (sizeof(std::pair<const long long, long long>) + 32); }
+};
+
+// Soluções visitadas numa tabela de endereçamento aberto (sondagem linear) de
+// capacidade fixa. Cada entrada guarda a iteração em que expira; quando metade
+// das posições está ocupada, a tabela é refeita só com as entradas vivas (no
+// máximo 'tenure'), o que mantém as sondagens curtas e a memória constante.
+struct MemoriaTabuHash {
+    struct Entrada {
+        uint64_t hash;
+        int expira;  // 0 = posição vazia
+    };
+    std::vector<Entrada> tabela;
+    uint64_t mascara;
+    int ocupadas = 0;
+    int tenure;
+
+    MemoriaTabuHash(int itens, int tenure) : tenure(tenure) {
+        (void)itens;
+        size_t cap = 16;
+        while (cap < 8 * (size_t)tenure) cap <<= 1;
+        tabela.assign(cap, Entrada{0, 0});
+        mascara = cap - 1;
+    }
+
+    bool tabu(long long hash, int item, int iter) const {
+        (void)item;
+        uint64_t h = (uint64_t)hash;
+        for (uint64_t p = h & mascara;; p = (p + 1) & mascara) {
+            const Entrada& e = tabela[p];
+            if (e.expira == 0) return false;
+            if (e.hash == h) return e.expira > iter;
+        }
+    }
+
+    void registrar(long long hash, int item, int iter) {
+        (void)item;
+        if (2 * (ocupadas + 1) > (int)tabela.size()) refazer(iter);
+        inserir((uint64_t)hash, iter + tenure);
+    }
+
+    size_t bytes() const { return tabela.size() * sizeof(Entrada); }
+
+private:
+    void inserir(uint64_t h, int expira) {
+        for (uint64_t p = h & mascara;; p = (p + 1) & mascara) {
+            Entrada& e = tabela[p];
+            if (e.expira == 0) {
+                e = Entrada{h, expira};
+                ocupadas++;
+                return;
+            }
+            if (e.hash == h) {
+                e.expira = expira;
+                return;
+            }
+        }
+    }
+
+    void refazer(int iter) {
+        std::vector<Entrada> vivas;
+        for (const Entrada& e : tabela) {
+            if (e.expira > iter) vivas.push_back(e);
+        }
+        std::fill(tabela.begin(), tabela.end(), Entrada{0, 0});
+        ocupadas = 0;
+        for (const Entrada& e : vivas) inserir(e.hash, e.expira);
+    }
+};
+
+// Tabu por atributo: o item invertido fica proibido por 'tenure' iterações.
+struct MemoriaTabuAtributo {
+    std::vector<int> tabu_ate;
+    int tenure;
+
+    MemoriaTabuAtributo(int itens, int tenure) : tabu_ate(itens, 0), tenure(tenure) {}
+
+    bool tabu(long long hash, int item, int iter) const {
+        (void)hash;
+        return tabu_ate[item] > iter;
+    }
+    void registrar(long long hash, int item, int iter) {
+        (void)hash;
+        if (item >= 0) tabu_ate[item] = iter + tenure;
+    }
+    size_t bytes() const { return tabu_ate.size() * sizeof(int); }
+};
+
+template <class Memoria>
+struct TipoMemoria {
+    typedef Memoria type;
+};
+
+inline bool modo_tabu_valido(const std::string& modo) {
+    return modo == "hash" || modo == "atributo" || modo == "map";
+}
+
+// Chama f(TipoMemoria<M>()) com a memória indicada por 'modo' (hash, atributo ou map).
+template <class F>
+auto com_memoria_tabu(const std::string& modo, F&& f) {
+    if (modo == "atributo") return f(TipoMemoria<MemoriaTabuAtributo>());
+    if (modo == "map") return f(TipoMemoria<MemoriaTabuMap>());
+    return f(TipoMemoria<MemoriaTabuHash>());
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// --- Orçamento de uma execução: tempo, iterações e estagnação ---
+//
+// Substitui a leitura do relógio a cada iteração. continuar() só consulta o
+// relógio a cada 'passo' iterações, e o passo é recalibrado a cada consulta
+// para que elas fiquem a cerca de INTERVALO_VERIFICACAO uma da outra: no SA,
+// cuja iteração custa dezenas de nanossegundos, o passo chega a milhares; no
+// GRASP/ILS, onde cada iteração é uma descida inteira, fica em 1. Os limites
+// de iterações e de estagnação são verificados sempre (são só comparações).
+//
+// Para registrar um ponto de convergência use decorrido(), que lê o relógio.
+//
+// Com 'limitante' (limitante.h) definido, melhorou(valor) encerra o orçamento
+// assim que o valor o atinge: a solução é provadamente ótima.
+
+const double INTERVALO_VERIFICACAO = 1e-3;  // segundos entre leituras do relógio
+const long long PASSO_MAXIMO = 1 << 20;
+
+struct Orcamento {
+    typedef std::chrono::steady_clock relogio;
+
+    double tempoLimite;
+    long long max_sem_melhora;  // < 0: sem limite
+    long long max_iteracoes;    // < 0: sem limite
+    long long iteracoes = 0;
+    long long sem_melhora = 0;
+    int limitante = INT_MAX;  // INT_MAX: desconhecido
+
+    explicit Orcamento(double tempoLimite, long long max_sem_melhora = -1, long long max_iteracoes = -1,
+                       relogio::time_point inicio = relogio::now())
+        : tempoLimite(tempoLimite), max_sem_melhora(max_sem_melhora), max_iteracoes(max_iteracoes), inicio(inicio),
+          ultima_verificacao(inicio) {}
+
+    // Chamado no topo de cada iteração.
+    bool continuar() {
+        if (max_sem_melhora >= 0 && sem_melhora > max_sem_melhora) return false;
+        if (max_iteracoes >= 0 && iteracoes >= max_iteracoes) return false;
+        if (esgotado) return false;
+        ++iteracoes;
+        if (--ate_verificar > 0) return true;
+        return verificar_relogio();
+    }
+
+    void melhorou() { sem_melhora = 0; }
+    void melhorou(int valor) {
+        melhorou();
+        if (valor >= limitante) esgotado = true;
+    }
+    void nao_melhorou(long long n = 1) { sem_melhora += n; }
+
+    double decorrido() const { return std::chrono::duration<double>(relogio::now() - inicio).count(); }
+
+private:
+    relogio::time_point inicio, ultima_verificacao;
+    long long passo = 1, ate_verificar = 1;
+    bool esgotado = false;
+
+    bool verificar_relogio() {
+        relogio::time_point agora = relogio::now();
+        if (std::chrono::duration<double>(agora - inicio).count() > tempoLimite) {
+            esgotado = true;
+            return false;
+        }
+        double intervalo = std::chrono::duration<double>(agora - ultima_verificacao).count();
+        ultima_verificacao = agora;
+        double fator = intervalo > 0 ? INTERVALO_VERIFICACAO / intervalo : 2.0;
+        fator = std::min(2.0, std::max(0.5, fator));  // ajuste suave
+        passo = std::min(PASSO_MAXIMO, std::max(1LL, (long long)(passo * fator)));
+        ate_verificar = passo;
+        return true;
+    }
+};
+
+// --- Leitura estrita de valores de opções ---
+//
+// O texto inteiro precisa ser o número: "0.9x", "" ou "12abc" são recusados,
+// assim como valores fora do intervalo (em vez de virarem 0 ou saturarem).
+
+// Número finito e positivo.
+inline bool ler_real_positivo(const char* texto, double& valor) {
+    char* fim = nullptr;
+    valor = std::strtod(texto, &fim);
+    return fim != texto && *fim == '\0' && std::isfinite(valor) && valor > 0;
+}
+
+// Inteiro sem sinal de 64 bits (sementes).
+inline bool ler_natural(const char* texto, uint64_t& valor) {
+    char* fim = nullptr;
+    errno = 0;
+    valor = std::strtoull(texto, &fim, 10);
+    return fim != texto && *fim == '\0' && errno == 0 && std::isdigit((unsigned char)*texto);
+}
+
+// Inteiro em [minimo, maximo].
+inline bool ler_inteiro_entre(const char* texto, long minimo, long maximo, long& valor) {
+    char* fim = nullptr;
+    errno = 0;
+    valor = std::strtol(texto, &fim, 10);
+    return fim != texto && *fim == '\0' && errno == 0 && valor >= minimo && valor <= maximo;
+}
+
+inline bool ler_inteiro_entre(const char* texto, int minimo, int maximo, int& valor) {
+    long lido;
+    if (!ler_inteiro_entre(texto, (long)minimo, (long)maximo, lido)) return false;
+    valor = (int)lido;
+    return true;
+}
+
+// Retira "--tempo <segundos>" de argv (se houver) e grava em tempoLimite.
+// Devolve false se o valor for inválido.
+inline bool ler_tempo_limite(int& argc, char* argv[], double& tempoLimite) {
+    for (int a = 1; a < argc; ++a) {
+        if (std::strcmp(argv[a], "--tempo") != 0) continue;
+        if (a + 1 >= argc || !ler_real_positivo(argv[a + 1], tempoLimite)) return false;
+        for (int b = a; b + 2 <= argc; ++b) argv[b] = argv[b + 2];
+        argc -= 2;
+        return true;
+    }
+    return true;
+}
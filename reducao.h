@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+#include <vector>
+
+#include "kpfs.h"
+#include "resultado.h"
+
+// --- Pré-processamento (presolve) da instância ---
+//
+// Reduz a instância antes dos algoritmos, sem mudar o valor ótimo:
+//   - itens mais pesados que a capacidade ou sem lucro (lucro <= 0) ficam
+//     fixos fora: nunca melhoram uma solução;
+//   - conjuntos de custo 0, ou que não podem passar do limite, são removidos.
+//     "Não pode passar" conta só os membros ainda livres e, entre eles, quantos
+//     cabem juntos na mochila (os mais leves primeiro);
+//   - itens de peso 0, com lucro > 0 e sem conjuntos ativos, ficam fixos
+//     dentro, e o lucro vai para valor_fixo;
+//   - conjuntos com os mesmos membros e o mesmo limite viram um só, com a soma
+//     dos custos.
+// As regras são repetidas até nada mudar (remover itens desativa conjuntos e
+// vice-versa). Dominância entre pares de itens não fixa variáveis na mochila
+// (os dois podem estar no ótimo), então só a dominância pela solução vazia
+// (lucro <= 0) é usada.
+//
+// A instância reduzida renumera itens e conjuntos; valor original = valor
+// reduzido + valor_fixo, e expandir() leva uma solução de volta aos índices
+// originais. Sem nada a reduzir (ou se tudo fosse fixado), a instância
+// original é usada como está, sem cópia.
+
+enum class FixacaoItem : char { Livre, Fora, Dentro };
+
+struct Reducao {
+    Instancia inst;                    // instância reduzida
+    int itens_originais = 0;
+    int conjuntos_originais = 0;
+    int valor_fixo = 0;                // lucro dos itens fixos dentro
+    std::vector<int> original;         // item reduzido -> item original
+    std::vector<FixacaoItem> fixacao;  // por item original
+    int conjuntos_removidos = 0, conjuntos_fundidos = 0;
+
+    explicit Reducao(Instancia&& entrada) {
+        itens_originais = entrada.itens;
+        conjuntos_originais = entrada.quant_conj;
+        fixacao.assign(entrada.itens, FixacaoItem::Livre);
+        std::vector<char> ativo(entrada.quant_conj, 1);
+        while (fixar_itens(entrada, ativo) | desativar_conjuntos(entrada, ativo)) {
+        }
+
+        int livres = (int)std::count(fixacao.begin(), fixacao.end(), FixacaoItem::Livre);
+        int ativos = (int)std::count(ativo.begin(), ativo.end(), 1);
+        if (livres == 0 || (livres == entrada.itens && ativos == entrada.quant_conj && !tem_duplicados(entrada))) {
+            identidade(std::move(entrada));
+            return;
+        }
+        montar_reduzida(entrada, ativo);
+    }
+
+    bool reduziu() const { return inst.itens != itens_originais || inst.quant_conj != conjuntos_originais; }
+
+    // Solução reduzida -> solução da instância original (itens fixos incluídos).
+    template <class SolucaoOriginal, class SolucaoReduzida>
+    SolucaoOriginal expandir(const SolucaoReduzida& s) const {
+        SolucaoOriginal r(itens_originais);
+        for (int i = 0; i < itens_originais; ++i) {
+            if (fixacao[i] == FixacaoItem::Dentro) r.set(i);
+        }
+        for (int k = 0; k < inst.itens; ++k) {
+            if (s[k]) r.set(original[k]);
+        }
+        return r;
+    }
+
+    // Leva um resultado da instância reduzida para a original.
+    void restaurar(Resultado& r) const {
+        if (valor_fixo == 0) return;
+        r.valor += valor_fixo;
+        for (auto& ponto : r.convergencia) ponto.second += valor_fixo;
+        if (r.limitante != INT_MAX) r.limitante += valor_fixo;
+    }
+
+private:
+    // Fixa itens com base nos conjuntos ativos; devolve se fixou algum.
+    bool fixar_itens(const Instancia& e, const std::vector<char>& ativo) {
+        bool mudou = false;
+        for (int i = 0; i < e.itens; ++i) {
+            if (fixacao[i] != FixacaoItem::Livre) continue;
+            if (e.peso[i] > e.capacidade || e.lucro[i] <= 0) {
+                fixacao[i] = FixacaoItem::Fora;
+                mudou = true;
+                continue;
+            }
+            if (e.peso[i] != 0) continue;
+            bool em_ativo = false;
+            for (int cj : e.conjuntos(i)) em_ativo |= ativo[cj] != 0;
+            if (!em_ativo) {
+                fixacao[i] = FixacaoItem::Dentro;
+                valor_fixo += e.lucro[i];
+                mudou = true;
+            }
+        }
+        return mudou;
+    }
+
+    // Desativa conjuntos que nunca cobram penalidade; devolve se desativou algum.
+    bool desativar_conjuntos(const Instancia& e, std::vector<char>& ativo) {
+        bool mudou = false;
+        std::vector<int> pesos;
+        for (int j = 0; j < e.quant_conj; ++j) {
+            if (!ativo[j]) continue;
+            pesos.clear();
+            for (int i : e.membros(j)) {
+                if (fixacao[i] != FixacaoItem::Fora) pesos.push_back(e.peso[i]);
+            }
+            int cabem = (int)pesos.size();
+            if (cabem > e.lim_conj[j]) {
+                std::sort(pesos.begin(), pesos.end());
+                long long soma = 0;
+                cabem = 0;
+                while (cabem < (int)pesos.size() && soma + pesos[cabem] <= e.capacidade) soma += pesos[cabem++];
+            }
+            if (e.custo_conj[j] == 0 || cabem <= e.lim_conj[j]) {
+                ativo[j] = 0;
+                conjuntos_removidos++;
+                mudou = true;
+            }
+        }
+        return mudou;
+    }
+
+    // Membros livres do conjunto j, ordenados, seguidos de -1 - limite (chave de fusão).
+    std::vector<int> chave(const Instancia& e, int j) const {
+        std::vector<int> k;
+        for (int i : e.membros(j)) {
+            if (fixacao[i] == FixacaoItem::Livre) k.push_back(i);
+        }
+        std::sort(k.begin(), k.end());
+        k.push_back(-1 - e.lim_conj[j]);
+        return k;
+    }
+
+    bool tem_duplicados(const Instancia& e) const {
+        std::vector<std::vector<int>> chaves;
+        for (int j = 0; j < e.quant_conj; ++j) chaves.push_back(chave(e, j));
+        std::sort(chaves.begin(), chaves.end());
+        return std::adjacent_find(chaves.begin(), chaves.end()) != chaves.end();
+    }
+
+    void identidade(Instancia&& entrada) {
+        std::fill(fixacao.begin(), fixacao.end(), FixacaoItem::Livre);
+        valor_fixo = 0;
+        conjuntos_removidos = 0;
+        original.resize(entrada.itens);
+        for (int i = 0; i < entrada.itens; ++i) original[i] = i;
+        inst = std::move(entrada);
+    }
+
+    void montar_reduzida(const Instancia& e, const std::vector<char>& ativo) {
+        DadosInstancia d;
+        d.capacidade = e.capacidade;
+        std::vector<int> novo(e.itens, -1);
+        for (int i = 0; i < e.itens; ++i) {
+            if (fixacao[i] != FixacaoItem::Livre) continue;
+            novo[i] = d.itens++;
+            original.push_back(i);
+            d.lucro.push_back(e.lucro[i]);
+            d.peso.push_back(e.peso[i]);
+        }
+
+        // Duplicados ficam vizinhos na ordem de chave; o primeiro de cada grupo
+        // (menor índice) representa os demais e leva a soma dos custos.
+        std::vector<std::pair<std::vector<int>, int>> chaves;
+        for (int j = 0; j < e.quant_conj; ++j) {
+            if (ativo[j]) chaves.push_back({chave(e, j), j});
+        }
+        std::sort(chaves.begin(), chaves.end());
+        std::vector<int> custo(e.quant_conj, 0), representante(e.quant_conj, -1);
+        for (size_t k = 0; k < chaves.size(); ++k) {
+            int j = chaves[k].second;
+            bool repetido = k > 0 && chaves[k].first == chaves[k - 1].first;
+            representante[j] = repetido ? representante[chaves[k - 1].second] : j;
+            custo[representante[j]] += e.custo_conj[j];
+            conjuntos_fundidos += repetido;
+        }
+
+        // Conjuntos na ordem original.
+        d.memb_inicio.push_back(0);
+        for (int j = 0; j < e.quant_conj; ++j) {
+            if (representante[j] != j) continue;
+            d.quant_conj++;
+            d.lim_conj.push_back(e.lim_conj[j]);
+            d.custo_conj.push_back(custo[j]);
+            for (int i : e.membros(j)) {
+                if (novo[i] >= 0) d.memb_idx.push_back(novo[i]);
+            }
+            d.memb_inicio.push_back((int)d.memb_idx.size());
+        }
+        inst.montar(d);
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "instrumentacao.h"
+#include "limitante.h"
+
+// --- Resultado de uma execução de qualquer algoritmo ---
+struct Resultado {
+    int valor = 0;
+    double tempo = 0;  // segundos, medido por quem chamou o algoritmo
+    int limitante = INT_MAX;  // limitante superior usado na execução (limitante.h)
+    std::vector<std::pair<double, int>> convergencia;  // (tempo decorrido, melhor valor)
+    Contadores contadores;  // zerados sem KPFS_INSTRUMENTACAO
+};
+
+// Junta os logs de convergência de várias threads: ordena por tempo e mantém só
+// os pontos que melhoram o valor anterior.
+inline std::vector<std::pair<double, int>> intercalar_convergencia(const std::vector<std::vector<std::pair<double, int>>>& logs) {
+    std::vector<std::pair<double, int>> todos, convergencia;
+    for (const auto& c : logs) todos.insert(todos.end(), c.begin(), c.end());
+    std::sort(todos.begin(), todos.end());
+    for (const auto& point : todos) {
+        if (convergencia.empty() || point.second > convergencia.back().second) convergencia.push_back(point);
+    }
+    return convergencia;
+}
+
+// Linha do arquivo de saída final: "valor tempo limitante gap".
+inline std::string formatar_saida(const Resultado& r) {
+    std::ostringstream out;
+    out << r.valor << " " << r.tempo << " " << r.limitante << " " << gap_otimalidade(r.valor, r.limitante) << '\n';
+    return out.str();
+}
+
+// Conteúdo do arquivo de convergência: um ponto "tempo valor" por linha.
+inline std::string formatar_convergencia(const Resultado& r) {
+    std::ostringstream out;
+    for (const auto& point : r.convergencia) out << point.first << " " << point.second << "\n";
+    return out.str();
+}
+
+inline bool escrever_convergencia(const std::string& caminho, const Resultado& r) {
+    std::ofstream arquivo(caminho);
+    if (!arquivo.is_open()) return false;
+    arquivo << formatar_convergencia(r);
+    return (bool)arquivo;
+}
+
+// Arquivo dos contadores: ao lado da saída final, uma linha JSON por execução.
+inline std::string caminho_contadores(const std::string& caminho_saida) { return caminho_saida + ".contadores.jsonl"; }
+
+inline std::string formatar_contadores(const Resultado& r) { return contadores_json(r.contadores, r.valor, r.tempo); }
+
+// Acrescenta o registro dos contadores; não faz nada sem KPFS_INSTRUMENTACAO.
+inline bool anexar_contadores(const std::string& caminho_saida, const Resultado& r) {
+    if (!INSTRUMENTACAO_ATIVA) return true;
+    std::ofstream arquivo(caminho_contadores(caminho_saida), std::ios::app);
+    if (!arquivo.is_open()) return false;
+    arquivo << formatar_contadores(r);
+    return (bool)arquivo;
+}
+
+// Acrescenta a linha do resultado ao arquivo de saída final.
+inline bool anexar_saida(const std::string& caminho, const Resultado& r) {
+    std::ofstream arquivo(caminho, std::ios::app);
+    if (!arquivo.is_open()) return false;
+    arquivo << formatar_saida(r);
+    return (bool)arquivo;
+}
@@ -0,0 +1,499 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "solver.h"
+
+// --- Servidor de resolução em lote ---
+//
+// Processo persistente que recebe pedidos pela entrada padrão ou por um socket
+// Unix, um objeto JSON por linha, e devolve um objeto JSON por linha para cada
+// pedido, na ordem em que terminam (o "id" do pedido volta na resposta):
+//
+//   {"id": 7, "instancia": "instances/scenario1/.../kpfs_1.txt", "algo": "grasp", "tempo": 0.5, "semente": 3}
+//   {"id": 8, "texto": "3 1 10\n...", "algo": "tabu", "variante": "atributo"}
+//
+//   {"id": 7, "algo": "grasp", "variante": "primeira", "valor": 512, "tempo": 0.5003, "limitante": 540, "gap": 0.0518}
+//   {"id": 9, "erro": "algoritmo ou variante inválida"}
+//
+// Campos do pedido: "instancia" (caminho, .kpfsb ou texto) ou "texto" (a
+// instância no formato texto), "algo", "variante", "tempo" (ou "time"),
+// "semente" (ou "seed"), "threads" (até o número de núcleos) e "convergencia" (true inclui os pontos de
+// convergência na resposta). Sem semente, usa o relógio.
+//
+// As instâncias lidas por caminho ficam em cache já reduzidas e com o
+// limitante calculado, identificadas pelo caminho, mtime e tamanho do arquivo;
+// nesse caso o tempo da resposta é só o do algoritmo. Uma instância em "texto"
+// é lida e reduzida a cada pedido, e o tempo inclui a redução, como no kpfs.
+// Os pedidos de todas as conexões vão para uma fila única atendida por um pool
+// de workers.
+
+namespace detalhe_servidor {
+
+struct ValorJson {
+    std::string texto;  // string já sem escapes, ou o literal (número, true...)
+    bool string = false;
+};
+
+inline std::string escapar_json(const std::string& s) {
+    std::string r = "\"";
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            r += '\\';
+            r += (char)c;
+        } else if (c == '\n') {
+            r += "\\n";
+        } else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            r += buf;
+        } else {
+            r += (char)c;
+        }
+    }
+    return r + "\"";
+}
+
+inline std::string para_json(const ValorJson& v) { return v.string ? escapar_json(v.texto) : v.texto; }
+
+// Os números de um pedido seguem as mesmas regras das opções de linha de
+// comando (orcamento.h).
+inline bool ler_positivo(const ValorJson& v, double& valor) { return ler_real_positivo(v.texto.c_str(), valor); }
+
+inline bool ler_semente(const ValorJson& v, uint64_t& valor) { return ler_natural(v.texto.c_str(), valor); }
+
+inline bool ler_inteiro(const ValorJson& v, long minimo, long maximo, long& valor) {
+    return ler_inteiro_entre(v.texto.c_str(), minimo, maximo, valor);
+}
+
+// Lê um objeto JSON plano (valores string, número ou literal; sem objetos ou
+// listas aninhados). false com a linha malformada.
+inline bool ler_objeto_json(const std::string& linha, std::map<std::string, ValorJson>& campos) {
+    size_t p = 0;
+    auto espacos = [&] {
+        while (p < linha.size() && std::isspace((unsigned char)linha[p])) ++p;
+    };
+    auto ler_string = [&](std::string& s) {
+        if (p >= linha.size() || linha[p] != '"') return false;
+        for (++p; p < linha.size() && linha[p] != '"'; ++p) {
+            if (linha[p] != '\\') {
+                s += linha[p];
+                continue;
+            }
+            if (++p >= linha.size()) return false;
+            switch (linha[p]) {
+                case 'n': s += '\n'; break;
+                case 't': s += '\t'; break;
+                case 'r': s += '\r'; break;
+                case 'b': s += '\b'; break;
+                case 'f': s += '\f'; break;
+                case 'u': {
+                    if (p + 4 >= linha.size()) return false;
+                    unsigned long c = std::strtoul(linha.substr(p + 1, 4).c_str(), nullptr, 16);
+                    if (c > 0x7f) return false;  // só ASCII: caminhos e instâncias não precisam de mais
+                    s += (char)c;
+                    p += 4;
+                    break;
+                }
+                default: s += linha[p];
+            }
+        }
+        if (p >= linha.size()) return false;
+        ++p;
+        return true;
+    };
+
+    espacos();
+    if (p >= linha.size() || linha[p++] != '{') return false;
+    espacos();
+    if (p < linha.size() && linha[p] == '}') return true;
+    while (true) {
+        std::string chave;
+        ValorJson valor;
+        espacos();
+        if (!ler_string(chave)) return false;
+        espacos();
+        if (p >= linha.size() || linha[p++] != ':') return false;
+        espacos();
+        if (p < linha.size() && linha[p] == '"') {
+            valor.string = true;
+            if (!ler_string(valor.texto)) return false;
+        } else {
+            size_t inicio = p;
+            while (p < linha.size() && linha[p] != ',' && linha[p] != '}' && !std::isspace((unsigned char)linha[p])) ++p;
+            valor.texto = linha.substr(inicio, p - inicio);
+            if (valor.texto.empty() || valor.texto[0] == '{' || valor.texto[0] == '[') return false;
+        }
+        campos[chave] = std::move(valor);
+        espacos();
+        if (p >= linha.size()) return false;
+        if (linha[p] == '}') return true;
+        if (linha[p++] != ',') return false;
+    }
+}
+
+// Linhas de um descritor, sem o '\n'.
+class LeitorLinhas {
+public:
+    explicit LeitorLinhas(int fd) : fd_(fd) {}
+
+    bool proxima(std::string& linha) {
+        while (true) {
+            size_t fim = buffer_.find('\n', inicio_);
+            if (fim != std::string::npos) {
+                linha.assign(buffer_, inicio_, fim - inicio_);
+                inicio_ = fim + 1;
+                return true;
+            }
+            buffer_.erase(0, inicio_);
+            inicio_ = 0;
+            char bloco[1 << 16];
+            ssize_t n = ::read(fd_, bloco, sizeof(bloco));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                if (buffer_.empty()) return false;
+                linha.swap(buffer_);  // última linha sem '\n'
+                buffer_.clear();
+                return true;
+            }
+            buffer_.append(bloco, (size_t)n);
+        }
+    }
+
+private:
+    int fd_;
+    std::string buffer_;
+    size_t inicio_ = 0;
+};
+
+}  // namespace detalhe_servidor
+
+// Uma origem de pedidos: entrada padrão/saída padrão ou um cliente do socket.
+// As respostas de workers diferentes saem inteiras, uma linha por vez.
+class Conexao {
+public:
+    Conexao(int entrada, int saida, bool fechar) : entrada_(entrada), saida_(saida), fechar_(fechar) {}
+    ~Conexao() {
+        if (fechar_) ::close(entrada_);
+    }
+
+    int entrada() const { return entrada_; }
+
+    void responder(const std::string& linha) {
+        std::lock_guard<std::mutex> lock(trava_);
+        for (size_t feito = 0; feito < linha.size();) {
+            ssize_t n = ::write(saida_, linha.data() + feito, linha.size() - feito);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;  // cliente foi embora: descarta
+            feito += (size_t)n;
+        }
+    }
+
+private:
+    int entrada_, saida_;
+    bool fechar_;
+    std::mutex trava_;
+};
+
+// Instância reduzida, com o limitante da reduzida (como em resolver_instancia()).
+struct InstanciaPreparada {
+    Reducao reducao;
+    int limitante;
+
+    explicit InstanciaPreparada(Instancia&& entrada)
+        : reducao(std::move(entrada)), limitante(limitante_superior(reducao.inst)) {}
+};
+
+// Cache de instâncias por caminho. Cada entrada vale enquanto o mtime e o
+// tamanho do arquivo não mudarem; passando da capacidade, sai a usada há mais
+// tempo. Pedidos simultâneos para o mesmo arquivo esperam uma única leitura.
+class CacheInstancias {
+public:
+    using Ptr = std::shared_ptr<const InstanciaPreparada>;
+
+    explicit CacheInstancias(size_t capacidade) : capacidade_(std::max<size_t>(capacidade, 1)) {}
+
+    // nullptr se o arquivo não existir ou estiver malformado.
+    Ptr obter(const std::string& caminho) {
+        struct stat st;
+        if (::stat(caminho.c_str(), &st) != 0) return nullptr;
+        int64_t mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+
+        std::unique_lock<std::mutex> lock(trava_);
+        auto it = entradas_.find(caminho);
+        if (it != entradas_.end() && it->second.mtime == mtime && it->second.tamanho == st.st_size) {
+            it->second.uso = ++relogio_;
+            std::shared_future<Ptr> pronta = it->second.pronta;
+            lock.unlock();
+            return pronta.get();
+        }
+
+        std::promise<Ptr> promessa;
+        uint64_t geracao = ++relogio_;
+        entradas_[caminho] = {mtime, st.st_size, geracao, geracao, promessa.get_future().share()};
+        while (entradas_.size() > capacidade_) {
+            auto velha = entradas_.begin();
+            for (auto e = entradas_.begin(); e != entradas_.end(); ++e) {
+                if (e->second.uso < velha->second.uso) velha = e;
+            }
+            entradas_.erase(velha);
+        }
+        lock.unlock();
+
+        Ptr pronta;
+        try {
+            Instancia entrada;
+            if (carregar_instancia(caminho, entrada)) pronta = std::make_shared<const InstanciaPreparada>(std::move(entrada));
+            promessa.set_value(pronta);
+        } catch (...) {
+            promessa.set_exception(std::current_exception());
+            esquecer(caminho, geracao);
+            throw;
+        }
+        if (!pronta) esquecer(caminho, geracao);
+        return pronta;
+    }
+
+private:
+    // Falhas não ficam em cache: o arquivo pode ser corrigido.
+    void esquecer(const std::string& caminho, uint64_t geracao) {
+        std::lock_guard<std::mutex> lock(trava_);
+        auto e = entradas_.find(caminho);
+        if (e != entradas_.end() && e->second.geracao == geracao) entradas_.erase(e);
+    }
+
+    struct Entrada {
+        int64_t mtime;
+        off_t tamanho;
+        uint64_t uso;
+        uint64_t geracao;
+        std::shared_future<Ptr> pronta;
+    };
+
+    size_t capacidade_;
+    std::mutex trava_;
+    std::map<std::string, Entrada> entradas_;
+    uint64_t relogio_ = 0;
+};
+
+class Servidor {
+public:
+    Servidor(int workers, size_t capacidade_cache)
+        : cache_(capacidade_cache), max_threads_(std::max(1u, std::thread::hardware_concurrency())) {
+        // Um Solver por algoritmo/variante, criado uma vez e compartilhado.
+        for (const std::string& nome : NOMES_ALGORITMOS) {
+            for (const std::string& variante : variantes_algoritmo(nome)) {
+                solvers_[{nome, variante}] = criar_solver(nome, variante);
+            }
+        }
+        for (int w = 0; w < workers; ++w) workers_.emplace_back([this] { trabalhar(); });
+    }
+
+    ~Servidor() { encerrar(); }
+
+    // Lê os pedidos da conexão até o fim da entrada; as respostas seguem
+    // chegando enquanto houver pedidos dela na fila.
+    void atender(const std::shared_ptr<Conexao>& conexao) {
+        detalhe_servidor::LeitorLinhas leitor(conexao->entrada());
+        std::string linha;
+        while (leitor.proxima(linha)) {
+            if (linha.find_first_not_of(" \t\r") == std::string::npos) continue;
+            {
+                std::lock_guard<std::mutex> lock(trava_);
+                fila_.push_back({conexao, std::move(linha)});
+            }
+            tem_pedido_.notify_one();
+            linha.clear();
+        }
+    }
+
+    // Espera a fila esvaziar e os workers terminarem.
+    void encerrar() {
+        {
+            std::lock_guard<std::mutex> lock(trava_);
+            encerrando_ = true;
+        }
+        tem_pedido_.notify_all();
+        for (std::thread& t : workers_) t.join();
+        workers_.clear();
+    }
+
+    // Resolve um pedido e devolve a linha da resposta.
+    std::string resolver(const std::string& linha) {
+        using detalhe_servidor::ValorJson;
+        std::map<std::string, ValorJson> campos;
+        if (!detalhe_servidor::ler_objeto_json(linha, campos)) return erro(nullptr, "pedido não é um objeto JSON válido");
+        auto campo = [&](const char* nome, const char* sinonimo = nullptr) -> const ValorJson* {
+            auto it = campos.find(nome);
+            if (it == campos.end() && sinonimo) it = campos.find(sinonimo);
+            return it == campos.end() ? nullptr : &it->second;
+        };
+        const ValorJson* id = campo("id");
+
+        const ValorJson* algo = campo("algo");
+        const ValorJson* variante = campo("variante");
+        std::string nome = algo ? algo->texto : "", modo = variante ? variante->texto : "";
+        std::vector<std::string> validas = variantes_algoritmo(nome);
+        if (modo.empty() && !validas.empty()) modo = validas[0];
+        auto solver = solvers_.find({nome, modo});
+        if (solver == solvers_.end()) return erro(id, "algoritmo ou variante inválida");
+
+        ConfigSolver cfg;
+        cfg.semente = semente_relogio();
+        const ValorJson* tempo = campo("tempo", "time");
+        if (tempo && !detalhe_servidor::ler_positivo(*tempo, cfg.tempo)) return erro(id, "tempo deve ser um número positivo");
+        const ValorJson* semente = campo("semente", "seed");
+        if (semente && !detalhe_servidor::ler_semente(*semente, cfg.semente)) {
+            return erro(id, "semente deve ser um inteiro sem sinal");
+        }
+        if (const ValorJson* v = campo("threads")) {
+            long threads = 0;
+            if (!detalhe_servidor::ler_inteiro(*v, 1, max_threads_, threads)) {
+                return erro(id, "threads deve ser um inteiro entre 1 e " + std::to_string(max_threads_));
+            }
+            cfg.threads = (int)threads;
+        }
+
+        Resultado resultado;
+        if (const ValorJson* caminho = campo("instancia")) {
+            CacheInstancias::Ptr preparada = cache_.obter(caminho->texto);
+            if (!preparada) return erro(id, "erro ao abrir a instância " + caminho->texto);
+            cfg.limitante = preparada->limitante;
+            resultado = resolver_reduzida(*solver->second, preparada->reducao, cfg);
+        } else if (const ValorJson* texto = campo("texto")) {
+            Instancia entrada;
+            const std::string& t = texto->texto;
+            if (!ler_instancia_texto(t.data(), t.data() + t.size(), entrada)) return erro(id, "instância em texto malformada");
+            resultado = resolver_instancia(*solver->second, std::move(entrada), cfg);
+        } else {
+            return erro(id, "pedido sem \"instancia\" nem \"texto\"");
+        }
+
+        std::ostringstream out;
+        out << "{";
+        if (id) out << "\"id\": " << detalhe_servidor::para_json(*id) << ", ";
+        out << "\"algo\": \"" << solver->second->nome() << "\", \"variante\": \"" << solver->second->variante()
+            << "\", \"valor\": " << resultado.valor << ", \"tempo\": " << resultado.tempo
+            << ", \"limitante\": " << resultado.limitante
+            << ", \"gap\": " << gap_otimalidade(resultado.valor, resultado.limitante);
+        const ValorJson* convergencia = campo("convergencia");
+        if (convergencia && convergencia->texto == "true") {
+            out << ", \"convergencia\": [";
+            for (size_t k = 0; k < resultado.convergencia.size(); ++k) {
+                out << (k ? ", [" : "[") << resultado.convergencia[k].first << ", " << resultado.convergencia[k].second << "]";
+            }
+            out << "]";
+        }
+        out << "}\n";
+        return out.str();
+    }
+
+private:
+    struct Pedido {
+        std::shared_ptr<Conexao> conexao;
+        std::string linha;
+    };
+
+    static std::string erro(const detalhe_servidor::ValorJson* id, const std::string& mensagem) {
+        std::string r = "{";
+        if (id) r += "\"id\": " + detalhe_servidor::para_json(*id) + ", ";
+        return r + "\"erro\": " + detalhe_servidor::escapar_json(mensagem) + "}\n";
+    }
+
+    void trabalhar() {
+        while (true) {
+            Pedido pedido;
+            {
+                std::unique_lock<std::mutex> lock(trava_);
+                tem_pedido_.wait(lock, [&] { return encerrando_ || !fila_.empty(); });
+                if (fila_.empty()) return;
+                pedido = std::move(fila_.front());
+                fila_.pop_front();
+            }
+            // Um pedido que falha (memória, criação de threads) recebe um erro;
+            // os outros pedidos e o processo seguem.
+            std::string resposta;
+            try {
+                resposta = resolver(pedido.linha);
+            } catch (const std::exception& e) {
+                std::map<std::string, detalhe_servidor::ValorJson> campos;
+                detalhe_servidor::ler_objeto_json(pedido.linha, campos);
+                auto id = campos.find("id");
+                resposta = erro(id == campos.end() ? nullptr : &id->second, std::string("falha ao resolver: ") + e.what());
+            }
+            pedido.conexao->responder(resposta);
+        }
+    }
+
+    CacheInstancias cache_;
+    long max_threads_;  // por pedido
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<Solver>> solvers_;
+    std::mutex trava_;
+    std::condition_variable tem_pedido_;
+    std::deque<Pedido> fila_;
+    bool encerrando_ = false;
+    std::vector<std::thread> workers_;
+};
+
+// Atende a entrada padrão até o fim ou, com 'socket', cada
+// cliente que se conectar, até o processo ser encerrado. Devolve o código de
+// saída do processo.
+inline int executar_servidor(const std::string& socket, int workers, size_t capacidade_cache) {
+    std::signal(SIGPIPE, SIG_IGN);  // cliente que fecha antes da resposta não derruba o servidor
+    Servidor servidor(workers, capacidade_cache);
+    if (socket.empty()) {
+        servidor.atender(std::make_shared<Conexao>(STDIN_FILENO, STDOUT_FILENO, false));
+        servidor.encerrar();
+        return 0;
+    }
+
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    if (socket.size() >= sizeof(endereco.sun_path)) {
+        std::cerr << "Caminho do socket muito longo: " << socket << "\n";
+        return 1;
+    }
+    std::strcpy(endereco.sun_path, socket.c_str());
+    int escuta = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(socket.c_str());
+    if (escuta < 0 || ::bind(escuta, (sockaddr*)&endereco, sizeof(endereco)) != 0 || ::listen(escuta, 64) != 0) {
+        std::cerr << "Erro ao abrir o socket " << socket << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    std::cerr << "Servidor em " << socket << " com " << workers << " workers.\n";
+    while (true) {
+        int cliente = ::accept(escuta, nullptr, nullptr);
+        if (cliente < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            std::cerr << "Erro no accept: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        auto conexao = std::make_shared<Conexao>(cliente, cliente, true);
+        std::thread([&servidor, conexao] { servidor.atender(conexao); }).detach();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// --- Suporte a SIMD com despacho em tempo de execução ---
+//
+// O programa é compilado sem -mavx2; as funções vetoriais levam
+// __attribute__((target(...))) e só são chamadas depois de cpu_tem_avx2() /
+// cpu_tem_avx512(). Fora de x86-64 com GCC/Clang, KPFS_X86 não é definido e só
+// os caminhos escalares existem.
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KPFS_X86 1
+#include <immintrin.h>
+#endif
+
+inline bool cpu_tem_avx2() {
+#ifdef KPFS_X86
+    static const bool tem = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return tem;
+#else
+    return false;
+#endif
+}
+
+inline bool cpu_tem_avx512() {
+#ifdef KPFS_X86
+    static const bool tem = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    return tem;
+#else
+    return false;
+#endif
+}
+
+inline bool cpu_tem_popcnt() {
+#ifdef KPFS_X86
+    static const bool tem = __builtin_cpu_supports("popcnt");
+    return tem;
+#else
+    return false;
+#endif
+}
+
+// VPOPCNTQ: popcount de 8 palavras de 64 bits por instrução.
+inline bool cpu_tem_avx512_popcnt() {
+#ifdef KPFS_X86
+    static const bool tem = cpu_tem_avx512() && __builtin_cpu_supports("avx512vpopcntdq");
+    return tem;
+#else
+    return false;
+#endif
+}
+
+#ifdef KPFS_X86
+// exp(x) para x em [-87, 0], erro relativo ~1e-7: x = n ln2 + r, |r| <= ln2/2,
+// e^r por polinômio de grau 6 e 2^n montado no expoente do float.
+__attribute__((target("avx2,fma"))) inline __m256 exp_aprox_avx2(__m256 x) {
+    x = _mm256_max_ps(x, _mm256_set1_ps(-87.0f));
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+    __m256 p = _mm256_set1_ps(1.0f / 720);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 120));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 24));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f / 6));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(0.5f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.0f));
+    __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+}
+#endif
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "kpfs.h"
+#include "orcamento.h"
+#include "resultado.h"
+#include "simd.h"
+#include "solucao.h"
+
+using namespace std;
+
+// --- Parâmetros da Meta-heurística ---
+const double alpha = 0.999;
+const double temperatura_inicial = 1000.0;
+const int SA_MAX_SEM_MELHORA = 100000;
+// Parallel tempering: escada geométrica de temperaturas fixas
+const double temperatura_min_pt = 1.0;
+const double temperatura_max_pt = 30.0;
+const int passos_por_troca = 2000;  // iterações de cada cadeia entre trocas
+// Modo em lote: propostas sorteadas e avaliadas juntas
+const int LOTE_SA = 8;
+
+// escalar: uma proposta por vez (original).
+// lote:    LOTE_SA propostas avaliadas de uma vez contra o mesmo estado; a
+//          primeira aceita é aplicada e as seguintes, descartadas. As rejeitadas
+//          antes dela são exatamente as rejeições que o laço escalar faria, então
+//          a cadeia é a mesma, só que com os deltas calculados com AVX2 e o
+//          teste de aceitação por um exp vetorial aproximado.
+enum class ModoSA { Escalar, Lote };
+
+inline bool ler_modo_sa(const string& nome, ModoSA& modo) {
+    if (nome == "escalar") {
+        modo = ModoSA::Escalar;
+    } else if (nome == "lote") {
+        modo = ModoSA::Lote;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// O modo é parâmetro de template dos algoritmos; com_modo_sa() chama
+// f(TipoModoSA<M>()) com o modo lido em tempo de execução.
+template <ModoSA Modo>
+using TipoModoSA = integral_constant<ModoSA, Modo>;
+
+template <class F>
+auto com_modo_sa(ModoSA modo, F&& f) {
+    if (modo == ModoSA::Lote) return f(TipoModoSA<ModoSA::Lote>());
+    return f(TipoModoSA<ModoSA::Escalar>());
+}
+ 
+// --- Estado de uma cadeia: solução, peso e itemsPorConj mantidos a cada flip ---
+template <class Solucao>
+struct EstadoSA {
+    const Instancia& inst;
+    Solucao currentItems;
+    int somaPeso = 0;
+    int currentValue = 0;
+    vector<contador_t> itemsPorConj;
+
+    explicit EstadoSA(const Instancia& inst) : inst(inst), currentItems(inst.itens), itemsPorConj(inst.quant_conj, 0) {}
+
+    // Solução inicial: itens sorteados que ainda cabem.
+    void iniciar(mt19937_64& rng) {
+        CONTAR(reavaliacoes);
+        uniform_int_distribution<int> item_dist(0, inst.itens - 1);
+        for (int i = 0; i < inst.itens; ++i) { 
+            int item_idx = item_dist(rng);
+            if (!currentItems[item_idx] && (somaPeso + inst.peso[item_idx] <= inst.capacidade)) {
+                currentItems.set(item_idx);
+                somaPeso += inst.peso[item_idx];
+            }
+        }
+ 
+        int initial_somaValor = 0;
+        int initial_somaPenalidade = 0;
+        fill(itemsPorConj.begin(), itemsPorConj.end(), 0);
+        for(int i = 0; i < inst.itens; ++i) {
+            if(currentItems[i]) {
+                initial_somaValor += inst.lucro[i];
+                for(int cj : inst.conjuntos(i)) {
+                    itemsPorConj[cj]++;
+                }
+            }
+        }
+        for(int j = 0; j < inst.quant_conj; ++j) {
+            if(itemsPorConj[j] > inst.lim_conj[j]) {
+                initial_somaPenalidade += (itemsPorConj[j] - inst.lim_conj[j]) * inst.custo_conj[j];
+            }
+        }
+        currentValue = initial_somaValor - initial_somaPenalidade;
+    }
+
+    // Valor da solução atual calculado do zero (conferência de currentValue).
+    int reavaliar() const {
+        vector<int> contagem(inst.quant_conj, 0);
+        int valor = 0;
+        for (int i = 0; i < inst.itens; ++i) {
+            if (!currentItems[i]) continue;
+            valor += inst.lucro[i];
+            for (int cj : inst.conjuntos(i)) contagem[cj]++;
+        }
+        for (int j = 0; j < inst.quant_conj; ++j) {
+            if (contagem[j] > inst.lim_conj[j]) valor -= (contagem[j] - inst.lim_conj[j]) * inst.custo_conj[j];
+        }
+        return valor;
+    }
+
+    // Variação do valor ao inverter 'itemFlip', ou INT_MIN se estoura a capacidade.
+    int delta(int itemFlip) const {
+        CONTAR(movimentos_avaliados);
+        int delta = 0;
+        if (currentItems[itemFlip]) {
+            delta = -inst.lucro[itemFlip];
+            for (int currConj : inst.conjuntos(itemFlip)) {
+                if (itemsPorConj[currConj] > inst.lim_conj[currConj]) {
+                    delta += inst.custo_conj[currConj];
+                }
+            }
+        } else {
+            if (somaPeso + inst.peso[itemFlip] > inst.capacidade) return INT_MIN;
+            delta = inst.lucro[itemFlip];
+            for (int currConj : inst.conjuntos(itemFlip)) {
+                if (itemsPorConj[currConj] + 1 > inst.lim_conj[currConj]) {
+                    delta -= inst.custo_conj[currConj];
+                }
+            }
+        }
+        return delta;
+    }
+
+    // delta() de LOTE_SA itens de uma vez.
+    void deltas_lote(const int* itens, int* deltas) const {
+#ifdef KPFS_X86
+        if (cpu_tem_avx2()) {
+            CONTAR_N(movimentos_avaliados, LOTE_SA);
+            deltas_lote_avx2(itens, deltas);
+            return;
+        }
+#endif
+        for (int k = 0; k < LOTE_SA; ++k) deltas[k] = delta(itens[k]);
+    }
+
+#ifdef KPFS_X86
+    // Um item por vez, vetorizado sobre a sua lista de conjuntos (contígua em
+    // conj_idx): 8 conjuntos por passo, com gathers dos contadores, limites e
+    // custos. O item paga custo no conjunto cj se itemsPorConj[cj] >=
+    // lim_conj[cj] + (item selecionado ? 1 : 0). Itens que não cabem saem antes
+    // de percorrer os conjuntos, como em delta().
+    __attribute__((target("avx2,fma"))) void deltas_lote_avx2(const int* itens, int* deltas) const {
+        static_assert(sizeof(contador_t) == 4, "gather de contadores de 32 bits");
+        const int* contadores = (const int*)(const void*)itemsPorConj.data();
+        for (int k = 0; k < LOTE_SA; ++k) {
+            int item = itens[k];
+            int sel = currentItems[item] ? 1 : 0;
+            if (!sel && somaPeso + inst.peso[item] > inst.capacidade) {
+                deltas[k] = INT_MIN;
+                continue;
+            }
+            const __m256i limiar = _mm256_set1_epi32(sel - 1);  // paga se cnt > lim + sel - 1
+            __m256i soma = _mm256_setzero_si256();
+            int p = inst.conj_inicio[item], fim = inst.conj_inicio[item + 1];
+            for (; p + 8 <= fim; p += 8) {
+                __m256i cj = _mm256_loadu_si256((const __m256i*)(inst.conj_idx + p));
+                __m256i cnt = _mm256_i32gather_epi32(contadores, cj, 4);
+                __m256i lim = _mm256_i32gather_epi32(inst.lim_conj, cj, 4);
+                __m256i custo = _mm256_i32gather_epi32(inst.custo_conj, cj, 4);
+                __m256i paga = _mm256_cmpgt_epi32(cnt, _mm256_add_epi32(lim, limiar));
+                soma = _mm256_add_epi32(soma, _mm256_and_si256(custo, paga));
+            }
+            __m128i s = _mm_add_epi32(_mm256_castsi256_si128(soma), _mm256_extracti128_si256(soma, 1));
+            s = _mm_hadd_epi32(s, s);
+            s = _mm_hadd_epi32(s, s);
+            int total = _mm_cvtsi128_si32(s);
+            for (; p < fim; ++p) {
+                int cj = inst.conj_idx[p];
+                if (itemsPorConj[cj] >= inst.lim_conj[cj] + sel) total += inst.custo_conj[cj];
+            }
+            deltas[k] = sel ? total - inst.lucro[item] : inst.lucro[item] - total;
+        }
+    }
+#endif
+
+    void aplicar(int itemFlip, int delta) {
+        CONTAR(movimentos_aceitos);
+        currentItems.flip(itemFlip);
+        currentValue += delta;
+
+        if (currentItems[itemFlip]) {
+            somaPeso += inst.peso[itemFlip];
+            for (int cj : inst.conjuntos(itemFlip)) itemsPorConj[cj]++;
+        } else {
+            somaPeso -= inst.peso[itemFlip];
+            for (int cj : inst.conjuntos(itemFlip)) itemsPorConj[cj]--;
+        }
+    }
+};
+
+// --- Passo em lote ---
+
+#ifdef KPFS_X86
+__attribute__((target("avx2,fma"))) inline int primeira_aceita_avx2(const int* deltas, const float* u, const float* temperaturas) {
+    __m256i d = _mm256_loadu_si256((const __m256i*)deltas);
+    __m256 x = _mm256_div_ps(_mm256_cvtepi32_ps(d), _mm256_loadu_ps(temperaturas));
+    __m256 p = exp_aprox_avx2(_mm256_min_ps(x, _mm256_setzero_ps()));
+    __m256i aceita = _mm256_or_si256(_mm256_cmpgt_epi32(d, _mm256_setzero_si256()),
+                                     _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(u), p, _CMP_LT_OQ)));
+    aceita = _mm256_andnot_si256(_mm256_cmpeq_epi32(d, _mm256_set1_epi32(INT_MIN)), aceita);
+    int mascara = _mm256_movemask_ps(_mm256_castsi256_ps(aceita));
+    return mascara ? __builtin_ctz(mascara) : LOTE_SA;
+}
+#endif
+
+// Índice da primeira proposta aceita pelo critério de Metropolis, ou LOTE_SA.
+// A proposta j usa a temperatura temperaturas[j]; u[j] é o sorteio em [0, 1).
+inline int primeira_aceita(const int* deltas, const float* u, const float* temperaturas) {
+#ifdef KPFS_X86
+    if (cpu_tem_avx2()) return primeira_aceita_avx2(deltas, u, temperaturas);
+#endif
+    for (int j = 0; j < LOTE_SA; ++j) {
+        if (deltas[j] == INT_MIN) continue;
+        if (deltas[j] > 0 || u[j] < exp(deltas[j] / temperaturas[j])) return j;
+    }
+    return LOTE_SA;
+}
+
+
+struct PassoLote {
+    int consumidas = 0;  // propostas usadas, até a aceita inclusive
+    int viaveis = 0;     // quantas delas respeitam a capacidade
+    bool aceito = false;
+};
+
+// Sorteia LOTE_SA flips (item e u saem do mesmo número de 64 bits), avalia
+// todos contra o estado atual e aplica o primeiro aceito. Como no laço escalar,
+// a temperatura só esfria (fator) a cada proposta viável: a proposta j usa
+// temperatura * fator^(viáveis antes de j).
+template <class Solucao>
+PassoLote passo_lote(EstadoSA<Solucao>& estado, mt19937_64& rng, double temperatura, double fator) {
+    alignas(32) int itens[LOTE_SA];
+    alignas(32) int deltas[LOTE_SA];
+    alignas(32) float u[LOTE_SA];
+    alignas(32) float temperaturas[LOTE_SA];
+    const uint64_t n = (uint64_t)estado.inst.itens;
+    for (int j = 0; j < LOTE_SA; ++j) {
+        uint64_t r = rng();
+        itens[j] = (int)(((r >> 32) * n) >> 32);
+        u[j] = (float)(uint32_t)r * (1.0f / 4294967296.0f);
+    }
+    estado.deltas_lote(itens, deltas);
+    for (int j = 0; j < LOTE_SA; ++j) {
+        temperaturas[j] = (float)max(temperatura, 1e-30);
+        if (deltas[j] != INT_MIN) temperatura *= fator;
+    }
+
+    PassoLote passo;
+    int j = primeira_aceita(deltas, u, temperaturas);
+    passo.aceito = j < LOTE_SA;
+    passo.consumidas = passo.aceito ? j + 1 : LOTE_SA;
+    for (int k = 0; k < passo.consumidas; ++k) passo.viaveis += deltas[k] != INT_MIN;
+    if (passo.aceito) estado.aplicar(itens[j], deltas[j]);
+    return passo;
+}
+
+template <class Solucao, ModoSA Modo = ModoSA::Escalar>
+Resultado Simulated_Annealing_Optimized(const Instancia& inst, mt19937_64& rng, double tempoLimite, int limitante = INT_MAX) {
+    contadores_thread() = Contadores();
+    auto inicio = chrono::high_resolution_clock::now();
+
+    // --- Inicialização ---
+    INSTRUMENTAR(CronometroFase construcao(contadores_thread().tempo_construcao);)
+    EstadoSA<Solucao> estado(inst);
+    estado.iniciar(rng);
+    INSTRUMENTAR(construcao.parar();)
+    uniform_int_distribution<int> item_dist(0, inst.itens - 1);
+    
+    // --- Variáveis do Algoritmo SA ---
+    int bestValue = estado.currentValue;
+    
+    double temperature = temperatura_inicial;
+
+    uniform_real_distribution<double> prob_dist(0.0, 1.0);
+    Orcamento orcamento(tempoLimite, SA_MAX_SEM_MELHORA);
+    orcamento.limitante = limitante;
+ 
+    vector<pair<double, int>> convergence_data; 
+    convergence_data.push_back({0.0, bestValue});
+
+    // --- Loop Principal ---
+    INSTRUMENTAR(CronometroFase busca(contadores_thread().tempo_busca_local);)
+    // potencia[c] = alpha^c: esfriamento depois de c propostas viáveis
+    double potencia[LOTE_SA + 1] = {1.0};
+    for (int c = 1; c <= LOTE_SA; ++c) potencia[c] = potencia[c - 1] * alpha;
+    while (Modo == ModoSA::Lote && orcamento.continuar()) {
+        PassoLote passo = passo_lote(estado, rng, temperature, alpha);
+        temperature *= potencia[passo.viaveis];
+        if (passo.aceito && estado.currentValue > bestValue) {
+            bestValue = estado.currentValue;
+            orcamento.melhorou(bestValue);
+            convergence_data.push_back({orcamento.decorrido(), bestValue});
+        } else if (passo.viaveis > 0) {
+            orcamento.nao_melhorou(passo.viaveis);
+        }
+    }
+    while (Modo == ModoSA::Escalar && orcamento.continuar()) {
+        int itemFlip = item_dist(rng);
+        int delta = estado.delta(itemFlip);
+        if (delta == INT_MIN) continue;
+        
+        if (delta > 0 || prob_dist(rng) < exp(delta / temperature)) {
+            estado.aplicar(itemFlip, delta);
+            
+            if (estado.currentValue > bestValue) {
+                bestValue = estado.currentValue;
+                orcamento.melhorou(bestValue);
+                convergence_data.push_back({orcamento.decorrido(), bestValue});
+            } else {
+                orcamento.nao_melhorou();
+            }
+        } else {
+            orcamento.nao_melhorou();
+        }
+        
+        temperature *= alpha;
+    }
+    INSTRUMENTAR(busca.parar();)
+    assert(estado.currentValue == estado.reavaliar());  // deltas (escalares ou em lote) acumulados sem erro
+
+    if (convergence_data.back().second < bestValue) {
+        convergence_data.push_back({tempoLimite, bestValue});
+    } else {
+        convergence_data.push_back({tempoLimite, convergence_data.back().second});
+    }
+
+    Resultado resultado;
+    resultado.valor = bestValue;
+    resultado.convergencia = move(convergence_data);
+    resultado.contadores = coletar_contadores(chrono::duration<double>(chrono::high_resolution_clock::now() - inicio).count());
+    return resultado;
+}
+
+// --- Barreira reutilizável: o último a chegar executa 'ao_completar' ---
+struct BarreiraSA {
+    mutex trava;
+    condition_variable cv;
+    int participantes, esperando = 0;
+    long long geracao = 0;
+    function<void()> ao_completar;
+
+    BarreiraSA(int participantes, function<void()> ao_completar)
+        : participantes(participantes), ao_completar(move(ao_completar)) {}
+
+    void chegar() {
+        unique_lock<mutex> lock(trava);
+        long long minha = geracao;
+        if (++esperando == participantes) {
+            ao_completar();
+            esperando = 0;
+            geracao++;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return geracao != minha; });
+        }
+    }
+};
+
+// --- Parallel tempering ---
+//
+// 'cadeias' cadeias, uma por thread, cada uma a uma temperatura fixa da escada
+// geométrica [temperatura_min_pt, temperatura_max_pt]; não há resfriamento.
+// Cada cadeia tem seu EstadoSA. A cada passos_por_troca iterações as threads
+// se encontram numa barreira e o último a chegar tenta trocar os estados de
+// temperaturas vizinhas (pares pares/ímpares alternados), aceitando com
+// probabilidade min(1, exp((1/T_i - 1/T_j) * (valor_j - valor_i))). A troca só
+// permuta os ponteiros dos estados. Para no tempo limite ou quando o melhor
+// valor atinge o limitante.
+template <class Solucao, ModoSA Modo = ModoSA::Escalar>
+Resultado Simulated_Annealing_Paralelo(const Instancia& inst, mt19937_64& rng, double tempoLimite, int cadeias, int limitante = INT_MAX) {
+    if (cadeias <= 1) return Simulated_Annealing_Optimized<Solucao, Modo>(inst, rng, tempoLimite, limitante);
+
+    vector<double> temperaturas(cadeias);
+    for (int k = 0; k < cadeias; ++k) {
+        temperaturas[k] = temperatura_min_pt * pow(temperatura_max_pt / temperatura_min_pt, (double)k / (cadeias - 1));
+    }
+
+    contadores_thread() = Contadores();
+    auto inicio = Orcamento::relogio::now();
+    vector<unique_ptr<EstadoSA<Solucao>>> estados;
+    vector<EstadoSA<Solucao>*> na_temperatura(cadeias);  // estado atualmente na temperatura k
+    vector<uint64_t> sementes(cadeias);
+    INSTRUMENTAR(CronometroFase construcao(contadores_thread().tempo_construcao);)
+    for (int k = 0; k < cadeias; ++k) {
+        estados.push_back(make_unique<EstadoSA<Solucao>>(inst));
+        estados[k]->iniciar(rng);
+        na_temperatura[k] = estados[k].get();
+        sementes[k] = rng();
+    }
+    INSTRUMENTAR(construcao.parar();)
+
+    atomic<int> bestValue(-2e9);
+    vector<vector<pair<double, int>>> convergencia_cadeia(cadeias);
+    vector<Contadores> contadores_cadeia(cadeias);
+    auto start_time = Orcamento::relogio::now();
+    Orcamento orcamento(tempoLimite, -1, -1, start_time);  // consultado só na barreira
+    auto decorrido = [&] { return orcamento.decorrido(); };
+    auto registrar = [&](int k, int valor) {
+        int atual = bestValue.load(memory_order_relaxed);
+        while (valor > atual) {
+            if (bestValue.compare_exchange_weak(atual, valor, memory_order_relaxed)) {
+                convergencia_cadeia[k].push_back({decorrido(), valor});
+                return;
+            }
+        }
+    };
+
+    bool parar = false;
+    int rodada = 0;
+    uniform_real_distribution<double> prob_troca(0.0, 1.0);
+    BarreiraSA barreira(cadeias, [&] {
+        // Executado por uma thread só, com as demais paradas
+        for (int k = rodada % 2; k + 1 < cadeias; k += 2) {
+            double vi = na_temperatura[k]->currentValue, vj = na_temperatura[k + 1]->currentValue;
+            double expoente = (1.0 / temperaturas[k] - 1.0 / temperaturas[k + 1]) * (vj - vi);
+            if (expoente >= 0 || prob_troca(rng) < exp(expoente)) swap(na_temperatura[k], na_temperatura[k + 1]);
+        }
+        rodada++;
+        parar = !orcamento.continuar() || bestValue.load(memory_order_relaxed) >= limitante;
+    });
+
+    auto cadeia = [&](int k) {
+        contadores_thread() = Contadores();
+        mt19937_64 rng_cadeia(sementes[k]);
+        uniform_int_distribution<int> item_dist(0, inst.itens - 1);
+        uniform_real_distribution<double> prob_dist(0.0, 1.0);
+        const double temperature = temperaturas[k];
+        registrar(k, na_temperatura[k]->currentValue);
+
+        while (!parar) {
+            EstadoSA<Solucao>& estado = *na_temperatura[k];
+            int melhor_rodada = estado.currentValue;
+            INSTRUMENTAR(CronometroFase busca(contadores_thread().tempo_busca_local);)
+            for (int passo = 0; Modo == ModoSA::Lote && passo < passos_por_troca;) {
+                PassoLote lote = passo_lote(estado, rng_cadeia, temperature, 1.0);
+                passo += lote.consumidas;
+                if (lote.aceito && estado.currentValue > melhor_rodada) {
+                    melhor_rodada = estado.currentValue;
+                    registrar(k, melhor_rodada);
+                }
+            }
+            for (int passo = 0; Modo == ModoSA::Escalar && passo < passos_por_troca; ++passo) {
+                int itemFlip = item_dist(rng_cadeia);
+                int delta = estado.delta(itemFlip);
+                if (delta == INT_MIN) continue;
+                if (delta > 0 || prob_dist(rng_cadeia) < exp(delta / temperature)) {
+                    estado.aplicar(itemFlip, delta);
+                    if (estado.currentValue > melhor_rodada) {
+                        melhor_rodada = estado.currentValue;
+                        registrar(k, melhor_rodada);
+                    }
+                }
+            }
+            INSTRUMENTAR(busca.parar();)
+            barreira.chegar();
+        }
+        contadores_cadeia[k] = coletar_contadores(decorrido());
+    };
+
+    vector<thread> pool;
+    for (int k = 0; k < cadeias; ++k) pool.emplace_back(cadeia, k);
+    for (thread& t : pool) t.join();
+    for (const auto& estado : estados) assert(estado->currentValue == estado->reavaliar());
+
+    vector<pair<double, int>> convergence_data = intercalar_convergencia(convergencia_cadeia);
+    int melhor = bestValue.load();
+    convergence_data.push_back({tempoLimite, melhor});
+
+    Resultado resultado;
+    resultado.valor = melhor;
+    resultado.convergencia = move(convergence_data);
+    resultado.contadores = coletar_contadores(chrono::duration<double>(start_time - inicio).count());
+    for (const Contadores& c : contadores_cadeia) resultado.contadores += c;
+    return resultado;
+}
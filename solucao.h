@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// --- Representação da solução ---
+//
+// Vetor de bits, um por item. SolucaoFixa<N> guarda N bits inline (cópia barata,
+// sem alocação) e SolucaoDinamica usa um vector de palavras para instâncias
+// maiores que a maior largura fixa. Os algoritmos são templates sobre o tipo de
+// solução; com_solucao() escolhe a instanciação pelo número de itens.
+//
+// Os bits acima de 'itens' ficam sempre zerados.
+
+template <class Derivada>
+struct BitsSolucao {
+    bool operator[](int i) const { return (palavras()[i >> 6] >> (i & 63)) & 1; }
+    bool test(int i) const { return (*this)[i]; }
+    void set(int i) { palavras()[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(int i) { palavras()[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    void flip(int i) { palavras()[i >> 6] ^= uint64_t(1) << (i & 63); }
+    void reset() { std::memset(palavras(), 0, num_palavras() * sizeof(uint64_t)); }
+
+    int count() const {
+        int total = 0;
+        for (int k = 0; k < num_palavras(); ++k) total += __builtin_popcountll(palavras()[k]);
+        return total;
+    }
+
+    bool operator==(const Derivada& outra) const {
+        return std::memcmp(palavras(), outra.palavras(), num_palavras() * sizeof(uint64_t)) == 0;
+    }
+    bool operator!=(const Derivada& outra) const { return !(*this == outra); }
+
+    uint64_t* palavras() { return static_cast<Derivada*>(this)->palavras(); }
+    const uint64_t* palavras() const { return static_cast<const Derivada*>(this)->palavras(); }
+    int num_palavras() const { return static_cast<const Derivada*>(this)->num_palavras(); }
+};
+
+template <int N>
+struct SolucaoFixa : BitsSolucao<SolucaoFixa<N>> {
+    static_assert(N % 64 == 0, "largura deve ser multiplo de 64");
+    static constexpr int CAPACIDADE = N;
+    uint64_t w[N / 64] = {};
+
+    explicit SolucaoFixa(int itens = 0) { (void)itens; }
+
+    uint64_t* palavras() { return w; }
+    const uint64_t* palavras() const { return w; }
+    int num_palavras() const { return N / 64; }
+};
+
+struct SolucaoDinamica : BitsSolucao<SolucaoDinamica> {
+    static constexpr int CAPACIDADE = -1;
+    std::vector<uint64_t> w;
+
+    explicit SolucaoDinamica(int itens = 0) : w((itens + 63) / 64, 0) {}
+
+    uint64_t* palavras() { return w.data(); }
+    const uint64_t* palavras() const { return w.data(); }
+    int num_palavras() const { return (int)w.size(); }
+};
+
+// Número de bits diferentes entre duas soluções.
+template <class Solucao>
+int distancia_hamming(const Solucao& a, const Solucao& b) {
+    int total = 0;
+    for (int k = 0; k < a.num_palavras(); ++k) total += __builtin_popcountll(a.palavras()[k] ^ b.palavras()[k]);
+    return total;
+}
+
+// Marca de tipo passada ao despachante.
+template <class Solucao>
+struct TipoSolucao {
+    typedef Solucao type;
+};
+
+// Chama f(TipoSolucao<S>()) com a menor representação que comporta 'itens'.
+// Uso: com_solucao(inst.itens, [&](auto t) { return Algoritmo<typename decltype(t)::type>(...); });
+template <class F>
+auto com_solucao(int itens, F&& f) {
+    if (itens <= 512) return f(TipoSolucao<SolucaoFixa<512>>());
+    if (itens <= 1024) return f(TipoSolucao<SolucaoFixa<1024>>());
+    if (itens <= 2048) return f(TipoSolucao<SolucaoFixa<2048>>());
+    if (itens <= 4096) return f(TipoSolucao<SolucaoFixa<4096>>());
+    return f(TipoSolucao<SolucaoDinamica>());
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "simulated_annealing.h"
+#include "tabu.h"
+#include "grasp.h"
+#include "ils.h"
+#include "limitante.h"
+#include "reducao.h"
+
+// --- Interface única dos algoritmos ---
+//
+// Solver é a única chamada virtual: uma por execução. Dentro de resolver() a
+// variante já é um parâmetro de template do algoritmo (memória tabu, modo de
+// aceitação do SA, busca local do GRASP/ILS) e a largura da solução é escolhida
+// por com_solucao(), então o laço principal não tem despacho em tempo de
+// execução. criar_solver() monta o Solver a partir dos nomes usados na linha de
+// comando.
+//
+// 'threads' vira workers no GRASP, ilhas no ILS e cadeias (parallel
+// tempering) no SA; a busca tabu é sequencial e o ignora.
+
+struct ConfigSolver {
+    double tempo = 2.0;
+    uint64_t semente = 0;
+    int threads = 1;
+    int limitante = INT_MAX;  // da instância passada a resolver()
+};
+
+class Solver {
+public:
+    virtual ~Solver() = default;
+    virtual std::string nome() const = 0;
+    virtual std::string variante() const = 0;
+    // Roda sobre 'inst' (só lida; pode ser compartilhada entre threads).
+    virtual Resultado resolver(const Instancia& inst, const ConfigSolver& cfg) const = 0;
+};
+
+template <class Memoria>
+class SolverTabu : public Solver {
+    std::string variante_;
+
+public:
+    explicit SolverTabu(std::string variante) : variante_(std::move(variante)) {}
+    std::string nome() const override { return "tabu"; }
+    std::string variante() const override { return variante_; }
+    Resultado resolver(const Instancia& inst, const ConfigSolver& cfg) const override {
+        std::mt19937_64 rng(cfg.semente);
+        return com_solucao(inst.itens, [&](auto t) {
+            return TABU_Optimized<typename decltype(t)::type, Memoria>(inst, rng, cfg.tempo, cfg.limitante);
+        });
+    }
+};
+
+template <ModoSA Modo>
+class SolverSA : public Solver {
+public:
+    std::string nome() const override { return "simulated_annealing"; }
+    std::string variante() const override { return Modo == ModoSA::Lote ? "lote" : "escalar"; }
+    Resultado resolver(const Instancia& inst, const ConfigSolver& cfg) const override {
+        std::mt19937_64 rng(cfg.semente);
+        return com_solucao(inst.itens, [&](auto t) {
+            return Simulated_Annealing_Paralelo<typename decltype(t)::type, Modo>(inst, rng, cfg.tempo, cfg.threads,
+                                                                                 cfg.limitante);
+        });
+    }
+};
+
+template <ModoBuscaLocal ModoBusca>
+class SolverGRASP : public Solver {
+public:
+    std::string nome() const override { return "grasp"; }
+    std::string variante() const override { return ModoBusca == ModoBuscaLocal::Melhor ? "melhor" : "primeira"; }
+    Resultado resolver(const Instancia& inst, const ConfigSolver& cfg) const override {
+        std::mt19937_64 rng(cfg.semente);
+        return com_solucao(inst.itens, [&](auto t) {
+            return GRASP_Paralelo<typename decltype(t)::type, ModoBusca>(inst, rng, cfg.tempo, cfg.threads, cfg.limitante);
+        });
+    }
+};
+
+template <ModoBuscaLocal ModoBusca>
+class SolverILS : public Solver {
+public:
+    std::string nome() const override { return "ils"; }
+    std::string variante() const override { return ModoBusca == ModoBuscaLocal::Melhor ? "melhor" : "primeira"; }
+    Resultado resolver(const Instancia& inst, const ConfigSolver& cfg) const override {
+        std::mt19937_64 rng(cfg.semente);
+        return com_solucao(inst.itens, [&](auto t) {
+            return ILS_Ilhas<typename decltype(t)::type, ModoBusca>(inst, rng, cfg.tempo, cfg.threads, cfg.limitante);
+        });
+    }
+};
+
+const std::vector<std::string> NOMES_ALGORITMOS = {"simulated_annealing", "tabu", "grasp", "ils"};
+
+inline bool algoritmo_valido(const std::string& nome) {
+    return std::find(NOMES_ALGORITMOS.begin(), NOMES_ALGORITMOS.end(), nome) != NOMES_ALGORITMOS.end();
+}
+
+// Variantes aceitas por algoritmo, a primeira é a padrão.
+inline std::vector<std::string> variantes_algoritmo(const std::string& nome) {
+    if (nome == "simulated_annealing") return {"escalar", "lote"};
+    if (nome == "tabu") return {"hash", "atributo", "map"};
+    if (nome == "grasp" || nome == "ils") return {"primeira", "melhor"};
+    return {};
+}
+
+// nullptr se o algoritmo ou a variante não existir. Variante vazia = padrão.
+inline std::unique_ptr<Solver> criar_solver(const std::string& nome, std::string variante = "") {
+    std::vector<std::string> validas = variantes_algoritmo(nome);
+    if (validas.empty()) return nullptr;
+    if (variante.empty()) variante = validas[0];
+    if (std::find(validas.begin(), validas.end(), variante) == validas.end()) return nullptr;
+
+    if (nome == "tabu") {
+        return com_memoria_tabu(variante, [&](auto m) -> std::unique_ptr<Solver> {
+            return std::make_unique<SolverTabu<typename decltype(m)::type>>(variante);
+        });
+    }
+    if (nome == "simulated_annealing") {
+        ModoSA modo = ModoSA::Escalar;
+        ler_modo_sa(variante, modo);
+        return com_modo_sa(modo, [](auto m) -> std::unique_ptr<Solver> {
+            return std::make_unique<SolverSA<decltype(m)::value>>();
+        });
+    }
+    ModoBuscaLocal modo = ModoBuscaLocal::Primeira;
+    ler_modo_busca_local(variante, modo);
+    return com_busca_local(modo, [&](auto m) -> std::unique_ptr<Solver> {
+        if (nome == "grasp") return std::make_unique<SolverGRASP<decltype(m)::value>>();
+        return std::make_unique<SolverILS<decltype(m)::value>>();
+    });
+}
+
+// Instância já reduzida (e limitante em cfg, calculado por quem chama): mede o
+// tempo em volta de resolver() e devolve o resultado na instância original.
+inline Resultado resolver_reduzida(const Solver& solver, const Reducao& reducao, const ConfigSolver& cfg) {
+    auto start = std::chrono::high_resolution_clock::now();
+    Resultado resultado = solver.resolver(reducao.inst, cfg);
+    resultado.tempo = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    resultado.limitante = cfg.limitante;
+    reducao.restaurar(resultado);
+    return resultado;
+}
+
+// Instância lida: o tempo inclui a redução e o limitante, como nos programas
+// de cada algoritmo.
+inline Resultado resolver_instancia(const Solver& solver, Instancia&& entrada, ConfigSolver cfg) {
+    auto start = std::chrono::high_resolution_clock::now();
+    Reducao reducao(std::move(entrada));
+    cfg.limitante = std::min(cfg.limitante, limitante_superior(reducao.inst));
+    Resultado resultado = solver.resolver(reducao.inst, cfg);
+    resultado.tempo = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    resultado.limitante = cfg.limitante;
+    reducao.restaurar(resultado);
+    return resultado;
+}
+
+inline uint64_t semente_relogio() { return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+// Corpo comum dos programas: lê 'dir_entrada', resolve e grava as saídas
+// (anexa em dir_saida_final, reescreve dir_saida_convergencia). Devolve o
+// código de saída do processo.
+inline int executar_programa(const Solver& solver, const std::string& dir_entrada, const std::string& dir_saida_final,
+                             const std::string& dir_saida_convergencia, const ConfigSolver& cfg) {
+    Instancia entrada;
+    if (!carregar_instancia(dir_entrada, entrada)) {
+        std::cout << "Erro ao abrir o arquivo: " << dir_entrada << std::endl;
+        return 1;
+    }
+    Resultado resultado = resolver_instancia(solver, std::move(entrada), cfg);
+
+    escrever_convergencia(dir_saida_convergencia, resultado);
+    if (!anexar_saida(dir_saida_final, resultado) || !anexar_contadores(dir_saida_final, resultado)) {
+        std::cout << "Erro ao abrir " << dir_saida_final << " para escrita.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "bits/stdc++.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <cassert>
+
+#include "kpfs.h"
+#include "orcamento.h"
+#include "resultado.h"
+#include "solucao.h"
+#include "avaliacao.h"
+#include "memoria_tabu.h"
+
+using namespace std;
+
+typedef long long ll;
+
+// --- Parâmetros da Meta-heurística ---
+const int TABU_TENURE = 100;          // memória por solução (hash/map)
+const int TABU_TENURE_ATRIBUTO = 20;  // memória por atributo (item)
+const int TABU_MAX_SEM_MELHORA = 500;
+
+template <class Solucao, class Memoria>
+Resultado TABU_Optimized(const Instancia& inst, mt19937_64& rng, double tempoLimite, int limitante = INT_MAX) {
+    const int itens = inst.itens;
+    contadores_thread() = Contadores();
+    auto inicio = chrono::high_resolution_clock::now();
+
+    // --- Estado da Solução ---
+    Solucao currentSolution(inst.itens);
+    int somaPeso = 0;
+
+    // --- Inicialização (Gulosa) ---
+    INSTRUMENTAR(CronometroFase construcao(contadores_thread().tempo_construcao);)
+    uniform_real_distribution<double> prob_dist(0.0, 1.0);
+    vector<pair<double, int>> candidates(itens);
+    for (int i = 0; i < itens; i++) {
+        candidates[i] = { (inst.peso[i] == 0 ? 1e12 + inst.lucro[i] : (double)inst.lucro[i] / inst.peso[i]), i };
+    }
+    sort(candidates.rbegin(), candidates.rend());
+    
+    double prob_alpha = 0.85; 
+    for (auto const& [ratio, currItem] : candidates) {
+        if (prob_dist(rng) < prob_alpha) {
+            if (somaPeso + inst.peso[currItem] <= inst.capacidade) {
+                currentSolution.set(currItem);
+                somaPeso += inst.peso[currItem];
+            }
+        }
+        prob_alpha *= 0.5;
+    }
+
+    // --- Variáveis da Busca Tabu ---
+    MotorGanho<Solucao> motor(inst);
+    motor.carregar(currentSolution);
+    
+    int bestValue = motor.valor;
+    
+    Memoria tabuList(itens, is_same<Memoria, MemoriaTabuAtributo>::value ? TABU_TENURE_ATRIBUTO : TABU_TENURE);
+    
+    uniform_int_distribution<ll> uid(0, 1e18);
+    vector<ll> rand_int(itens);
+    for(ll &i: rand_int) i = uid(rng);
+
+    ll chash = 0;
+    for(int i = 0; i < itens; i++){
+        if(currentSolution[i]) chash ^= rand_int[i];
+    }
+
+    tabuList.registrar(chash, -1, 0);
+    INSTRUMENTAR(construcao.parar();)
+
+    Orcamento orcamento(tempoLimite, TABU_MAX_SEM_MELHORA);
+    orcamento.limitante = limitante;
+    int iter = 0;
+ 
+    vector<pair<double, int>> convergence_data; 
+    convergence_data.push_back({0.0, bestValue});
+
+    // --- Loop Principal da Busca Tabu ---
+    while (orcamento.continuar()) {
+        iter++;
+
+        // Aspiração: um movimento tabu é aceito se supera a melhor solução
+        INSTRUMENTAR(CronometroFase busca(contadores_thread().tempo_busca_local);)
+        int best_move_item = motor.melhor_movimento([&](int itemFlip) {
+            if (motor.valor + motor.ganho[itemFlip] > bestValue) {
+                INSTRUMENTAR(if (tabuList.tabu(chash ^ rand_int[itemFlip], itemFlip, iter)) CONTAR(aspiracoes);)
+                return true;
+            }
+            bool proibido = tabuList.tabu(chash ^ rand_int[itemFlip], itemFlip, iter);
+            if (proibido) CONTAR(tabu_bloqueios);
+            return !proibido;
+        });
+        INSTRUMENTAR(busca.parar();)
+
+        if (best_move_item == -1) break; 
+        int best_neighbor_value = motor.valor + motor.ganho[best_move_item];
+         
+        if (best_neighbor_value > bestValue) {
+            bestValue = best_neighbor_value;
+            convergence_data.push_back({orcamento.decorrido(), bestValue});
+            orcamento.melhorou(bestValue);
+        } else {
+            orcamento.nao_melhorou();
+        }
+
+        chash ^= rand_int[best_move_item];
+        {
+            FASE(tempo_busca_local);
+            motor.aplicar(best_move_item);
+        }
+        
+        tabuList.registrar(chash, best_move_item, iter);
+    }
+
+    if (convergence_data.back().second < bestValue) {
+        convergence_data.push_back({tempoLimite, bestValue});
+    } else {
+        convergence_data.push_back({tempoLimite, convergence_data.back().second});
+    }
+
+    Resultado resultado;
+    resultado.valor = bestValue;
+    resultado.convergencia = move(convergence_data);
+    resultado.contadores = coletar_contadores(chrono::duration<double>(chrono::high_resolution_clock::now() - inicio).count());
+    return resultado;
+}
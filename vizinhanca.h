@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "kpfs.h"
+#include "simd.h"
+
+// --- Vizinhança completa de flip em SIMD ---
+//
+// avaliar_vizinhanca() calcula, para todos os itens, o ganho do flip (valor
+// após - valor atual, sem considerar a capacidade) e se o flip cabe na
+// mochila. Os filtros de cada algoritmo (tabu, aspiração) ficam para depois,
+// numa passada separada sobre esses vetores.
+//
+// Para os caminhos vetoriais, LayoutVizinhanca reorganiza a adjacência item ->
+// conjuntos: os itens são ordenados por grau decrescente e agrupados em blocos
+// de BLOCO faixas; cada bloco tem as listas completadas até o grau do seu
+// primeiro item (o maior) e guardadas transpostas, de modo que o d-ésimo
+// conjunto das BLOCO faixas fica contíguo. Limite e custo já vêm copiados para
+// cada posição, e só o contador precisa de gather. Posições de preenchimento
+// têm custo 0 e nunca contribuem.
+
+struct LayoutVizinhanca {
+    static const int BLOCO = 16;  // faixas AVX-512; o AVX2 faz duas metades
+
+    int blocos = 0;
+    std::vector<int> item;         // item[b * BLOCO + k]; -1 = faixa vazia
+    std::vector<int> lucro, peso;  // por faixa
+    std::vector<int> grau;         // grau[b]: linhas do bloco b
+    std::vector<int> inicio;       // primeira linha do bloco b
+    std::vector<int> conj, lim, custo;  // posição (linha, k) em linha * BLOCO + k
+
+    LayoutVizinhanca() = default;
+
+    explicit LayoutVizinhanca(const Instancia& inst) {
+        std::vector<int> ordem(inst.itens);
+        for (int i = 0; i < inst.itens; ++i) ordem[i] = i;
+        std::stable_sort(ordem.begin(), ordem.end(), [&](int a, int b) {
+            return inst.conjuntos(a).size() > inst.conjuntos(b).size();
+        });
+        blocos = (inst.itens + BLOCO - 1) / BLOCO;
+        item.assign((size_t)blocos * BLOCO, -1);
+        lucro.assign(item.size(), 0);
+        peso.assign(item.size(), 0);
+        grau.assign(blocos, 0);
+        inicio.assign(blocos + 1, 0);
+        for (int b = 0; b < blocos; ++b) {
+            grau[b] = inst.conjuntos(ordem[b * BLOCO]).size();
+            inicio[b + 1] = inicio[b] + grau[b];
+        }
+        size_t posicoes = (size_t)inicio[blocos] * BLOCO;
+        conj.assign(posicoes, 0);
+        lim.assign(posicoes, 0);
+        custo.assign(posicoes, 0);
+        for (int p = 0; p < inst.itens; ++p) {
+            int b = p / BLOCO, k = p % BLOCO, i = ordem[p];
+            item[p] = i;
+            lucro[p] = inst.lucro[i];
+            peso[p] = inst.peso[i];
+            int d = 0;
+            for (int cj : inst.conjuntos(i)) {
+                size_t pos = (size_t)(inicio[b] + d++) * BLOCO + k;
+                conj[pos] = cj;
+                lim[pos] = inst.lim_conj[cj];
+                custo[pos] = inst.custo_conj[cj];
+            }
+        }
+    }
+
+    bool vazio() const { return item.empty(); }
+};
+
+// Ganho do flip de um item percorrendo seus conjuntos (caminho escalar).
+template <class Solucao, class Contador>
+inline int ganho_flip(const Instancia& inst, const Solucao& sol, const std::vector<Contador>& itemsPorConj, int item) {
+    int delta;
+    if (sol[item]) {
+        delta = -inst.lucro[item];
+        for (int cj : inst.conjuntos(item)) {
+            if (itemsPorConj[cj] > inst.lim_conj[cj]) delta += inst.custo_conj[cj];
+        }
+    } else {
+        delta = inst.lucro[item];
+        for (int cj : inst.conjuntos(item)) {
+            if (itemsPorConj[cj] + 1 > inst.lim_conj[cj]) delta -= inst.custo_conj[cj];
+        }
+    }
+    return delta;
+}
+
+#ifdef KPFS_X86
+// Faixa k paga custo na posição se itemsPorConj[conj] > lim + sel[k] - 1.
+__attribute__((target("avx512f,avx512bw"))) inline void avaliar_blocos_avx512(
+    const LayoutVizinhanca& lay, const int* contadores, const int* sel, int b, int* ganho, int* folga_peso, int somaPeso) {
+    __m512i s = _mm512_loadu_si512(sel + b * LayoutVizinhanca::BLOCO);
+    __m512i limiar = _mm512_sub_epi32(s, _mm512_set1_epi32(1));
+    __m512i soma = _mm512_setzero_si512();
+    for (int linha = lay.inicio[b]; linha < lay.inicio[b + 1]; ++linha) {
+        size_t pos = (size_t)linha * LayoutVizinhanca::BLOCO;
+        __m512i cj = _mm512_loadu_si512(lay.conj.data() + pos);
+        __m512i cnt = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, cj, contadores, 4);
+        __m512i lim = _mm512_add_epi32(_mm512_loadu_si512(lay.lim.data() + pos), limiar);
+        __mmask16 paga = _mm512_cmpgt_epi32_mask(cnt, lim);
+        soma = _mm512_mask_add_epi32(soma, paga, soma, _mm512_loadu_si512(lay.custo.data() + pos));
+    }
+    size_t faixa = (size_t)b * LayoutVizinhanca::BLOCO;
+    __m512i lucro = _mm512_loadu_si512(lay.lucro.data() + faixa);
+    __mmask16 dentro = _mm512_test_epi32_mask(s, s);
+    __m512i g = _mm512_mask_sub_epi32(_mm512_sub_epi32(lucro, soma), dentro, soma, lucro);
+    _mm512_storeu_si512(ganho, g);
+    // folga_peso < 0: o flip estoura a capacidade (itens dentro sempre cabem)
+    __m512i folga = _mm512_sub_epi32(_mm512_set1_epi32(-somaPeso), _mm512_loadu_si512(lay.peso.data() + faixa));
+    _mm512_storeu_si512(folga_peso, _mm512_mask_mov_epi32(folga, dentro, _mm512_setzero_si512()));
+}
+
+__attribute__((target("avx2,fma"))) inline void avaliar_blocos_avx2(
+    const LayoutVizinhanca& lay, const int* contadores, const int* sel, int b, int* ganho, int* folga_peso, int somaPeso) {
+    for (int metade = 0; metade < LayoutVizinhanca::BLOCO; metade += 8) {
+        size_t faixa = (size_t)b * LayoutVizinhanca::BLOCO + metade;
+        __m256i s = _mm256_loadu_si256((const __m256i*)(sel + faixa));
+        __m256i limiar = _mm256_sub_epi32(s, _mm256_set1_epi32(1));
+        __m256i soma = _mm256_setzero_si256();
+        for (int linha = lay.inicio[b]; linha < lay.inicio[b + 1]; ++linha) {
+            size_t pos = (size_t)linha * LayoutVizinhanca::BLOCO + metade;
+            __m256i cj = _mm256_loadu_si256((const __m256i*)(lay.conj.data() + pos));
+            __m256i cnt = _mm256_i32gather_epi32(contadores, cj, 4);
+            __m256i lim = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(lay.lim.data() + pos)), limiar);
+            __m256i paga = _mm256_cmpgt_epi32(cnt, lim);
+            soma = _mm256_add_epi32(soma, _mm256_and_si256(paga, _mm256_loadu_si256((const __m256i*)(lay.custo.data() + pos))));
+        }
+        __m256i lucro = _mm256_loadu_si256((const __m256i*)(lay.lucro.data() + faixa));
+        __m256i dentro = _mm256_cmpeq_epi32(s, _mm256_set1_epi32(1));
+        __m256i g = _mm256_blendv_epi8(_mm256_sub_epi32(lucro, soma), _mm256_sub_epi32(soma, lucro), dentro);
+        _mm256_storeu_si256((__m256i*)(ganho + metade), g);
+        __m256i folga = _mm256_sub_epi32(_mm256_set1_epi32(-somaPeso), _mm256_loadu_si256((const __m256i*)(lay.peso.data() + faixa)));
+        _mm256_storeu_si256((__m256i*)(folga_peso + metade), _mm256_andnot_si256(dentro, folga));
+    }
+}
+#endif
+
+// Preenche ganho[i] para todos os itens e, se cabe != nullptr, cabe[i] = o flip
+// de i respeita a capacidade. Usa AVX-512 ou AVX2 quando a CPU tem e o layout
+// foi montado; senão, o laço escalar sobre a CSR da instância. 'selecao' é
+// memória de rascunho do chamador (a solução por faixa do layout), reusada de
+// uma chamada para outra.
+template <class Solucao, class Contador>
+void avaliar_vizinhanca(const Instancia& inst, const LayoutVizinhanca& lay, const Solucao& sol,
+                        const std::vector<Contador>& itemsPorConj, int somaPeso, int* ganho, char* cabe,
+                        std::vector<int>& selecao) {
+#ifdef KPFS_X86
+    static_assert(sizeof(Contador) == 4, "gather de contadores de 32 bits");
+    bool avx512 = cpu_tem_avx512(), avx2 = cpu_tem_avx2();
+    if (!lay.vazio() && (avx512 || avx2)) {
+        const int* contadores = (const int*)(const void*)itemsPorConj.data();
+        selecao.resize(lay.item.size());
+        int* sel = selecao.data();
+        for (size_t p = 0; p < lay.item.size(); ++p) sel[p] = lay.item[p] >= 0 && sol[lay.item[p]];
+        alignas(64) int g[LayoutVizinhanca::BLOCO];
+        alignas(64) int f[LayoutVizinhanca::BLOCO];
+        for (int b = 0; b < lay.blocos; ++b) {
+            if (avx512) avaliar_blocos_avx512(lay, contadores, sel, b, g, f, somaPeso);
+            else avaliar_blocos_avx2(lay, contadores, sel, b, g, f, somaPeso);
+            for (int k = 0; k < LayoutVizinhanca::BLOCO; ++k) {
+                int item = lay.item[b * LayoutVizinhanca::BLOCO + k];
+                if (item < 0) break;  // só o último bloco tem faixas vazias, no fim
+                ganho[item] = g[k];
+                if (cabe) cabe[item] = f[k] + inst.capacidade >= 0;
+            }
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < inst.itens; ++i) {
+        ganho[i] = ganho_flip(inst, sol, itemsPorConj, i);
+        if (cabe) cabe[i] = sol[i] || somaPeso + inst.peso[i] <= inst.capacidade;
+    }
+}